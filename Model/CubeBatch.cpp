@@ -0,0 +1,196 @@
+#include "CubeBatch.h"
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // One vector of lanes, with the few byte operations the batch needs.
+    // Without AVX2 a vector is a single lane.
+#if defined(__AVX512BW__)
+    typedef __m512i Vec;
+    const int WIDTH = 64;
+    Vec load(const uint8_t *p) { return _mm512_load_si512(p); }
+    void store(uint8_t *p, Vec v) { _mm512_store_si512(p, v); }
+    Vec splat(uint8_t x) { return _mm512_set1_epi8((char) x); }
+    Vec add(Vec a, Vec b) { return _mm512_add_epi8(a, b); }
+    Vec sub(Vec a, Vec b) { return _mm512_sub_epi8(a, b); }
+    Vec minU(Vec a, Vec b) { return _mm512_min_epu8(a, b); }
+    Vec orV(Vec a, Vec b) { return _mm512_or_si512(a, b); }
+    Vec xorV(Vec a, Vec b) { return _mm512_xor_si512(a, b); }
+    Vec greaterThan(Vec a, Vec b) { return _mm512_movm_epi8(_mm512_cmpgt_epu8_mask(a, b)); }
+    uint64_t zeroLanes(Vec v) { return _mm512_testn_epi8_mask(v, v); }
+#elif defined(__AVX2__)
+    typedef __m256i Vec;
+    const int WIDTH = 32;
+    Vec load(const uint8_t *p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    void store(uint8_t *p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    Vec splat(uint8_t x) { return _mm256_set1_epi8((char) x); }
+    Vec add(Vec a, Vec b) { return _mm256_add_epi8(a, b); }
+    Vec sub(Vec a, Vec b) { return _mm256_sub_epi8(a, b); }
+    Vec minU(Vec a, Vec b) { return _mm256_min_epu8(a, b); }
+    Vec orV(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    Vec xorV(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    // Values here are below 128, so the signed compare is enough
+    Vec greaterThan(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+    uint64_t zeroLanes(Vec v) {
+        return (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    }
+#else
+    typedef uint8_t Vec;
+    const int WIDTH = 1;
+    Vec load(const uint8_t *p) { return *p; }
+    void store(uint8_t *p, Vec v) { *p = v; }
+    Vec splat(uint8_t x) { return x; }
+    Vec add(Vec a, Vec b) { return a + b; }
+    Vec sub(Vec a, Vec b) { return a - b; }
+    Vec minU(Vec a, Vec b) { return min(a, b); }
+    Vec orV(Vec a, Vec b) { return a | b; }
+    Vec xorV(Vec a, Vec b) { return a ^ b; }
+    Vec greaterThan(Vec a, Vec b) { return a > b ? 0xFF : 0; }
+    uint64_t zeroLanes(Vec v) { return v == 0; }
+#endif
+
+    // x mod 3 for x in 0..5: x - 3 wraps around below 3
+    Vec mod3(Vec x) {
+        return minU(x, sub(x, splat(3)));
+    }
+
+    // Whether the sticker-order twist at each position is the negated
+    // cubie twist (see CornerCubies::getCornerOrientation)
+    const array<bool, 8>& getMirrored() {
+        static const array<bool, 8> mirrored = [] {
+            array<bool, 8> res{};
+            for (uint8_t i = 0; i < 8; i++) {
+                CornerCubies probe;
+                probe.co[i] = 1;
+                res[i] = probe.getCornerOrientation(i) == 2;
+            }
+            return res;
+        }();
+        return mirrored;
+    }
+}
+
+CubeBatch::CubeBatch() {
+    for (int i = 0; i < 8; i++) {
+        cornerRow[i] = i;
+        twistRow[i] = 8 + i;
+    }
+    for (int i = 0; i < 12; i++) {
+        edgeRow[i] = 16 + i;
+        flipRow[i] = 28 + i;
+    }
+    CubieCube solved;
+    for (int lane = 0; lane < LANES; lane++) set(lane, solved);
+}
+
+void CubeBatch::set(int lane, const CubieCube &cube) {
+    for (uint8_t i = 0; i < 8; i++) {
+        rows[cornerRow[i]][lane] = cube.corners.getCornerIndex(i);
+        rows[twistRow[i]][lane] = cube.corners.co[i];
+    }
+    for (int i = 0; i < 12; i++) {
+        rows[edgeRow[i]][lane] = cube.edges.ep[i];
+        rows[flipRow[i]][lane] = cube.edges.eo[i];
+    }
+}
+
+CubieCube CubeBatch::get(int lane) const {
+    CubieCube cube;
+    for (uint8_t i = 0; i < 8; i++) {
+        cube.corners.setCornerIndex(i, rows[cornerRow[i]][lane]);
+        cube.corners.co[i] = rows[twistRow[i]][lane];
+    }
+    for (int i = 0; i < 12; i++) {
+        cube.edges.ep[i] = rows[edgeRow[i]][lane];
+        cube.edges.eo[i] = rows[flipRow[i]][lane];
+    }
+    return cube;
+}
+
+// Position i receives the cubie from position move.cp[i], with the move's
+// twist added (see CornerCubies::multiply)
+void CubeBatch::apply(RubiksCube::MOVE move) {
+    const CornerCubies &mc = CornerCubies::getMove(move);
+    const EdgeCubies &me = EdgeCubies::getMove(move);
+
+    uint8_t corners[8], twists[8], edges[12], flips[12];
+    for (int i = 0; i < 8; i++) {
+        corners[i] = cornerRow[mc.cp[i]];
+        twists[i] = twistRow[mc.cp[i]];
+    }
+    for (int i = 0; i < 12; i++) {
+        edges[i] = edgeRow[me.ep[i]];
+        flips[i] = flipRow[me.ep[i]];
+    }
+    memcpy(cornerRow, corners, 8);
+    memcpy(twistRow, twists, 8);
+    memcpy(edgeRow, edges, 12);
+    memcpy(flipRow, flips, 12);
+
+    for (int i = 0; i < 8; i++) {
+        if (!mc.co[i]) continue;
+        Vec twist = splat(mc.co[i]);
+        uint8_t *row = rows[twistRow[i]];
+        for (int k = 0; k < LANES; k += WIDTH) store(row + k, mod3(add(load(row + k), twist)));
+    }
+    for (int i = 0; i < 12; i++) {
+        if (!me.eo[i]) continue;
+        Vec one = splat(1);
+        uint8_t *row = rows[flipRow[i]];
+        for (int k = 0; k < LANES; k += WIDTH) store(row + k, xorV(load(row + k), one));
+    }
+}
+
+uint64_t CubeBatch::getSolvedMask() const {
+    CornerCubies solved;
+    uint64_t mask = 0;
+    for (int k = 0; k < LANES; k += WIDTH) {
+        // Any difference from solved in any field
+        Vec diff = splat(0);
+        for (uint8_t i = 0; i < 8; i++) {
+            diff = orV(diff, xorV(load(rows[cornerRow[i]] + k), splat(solved.getCornerIndex(i))));
+            diff = orV(diff, load(rows[twistRow[i]] + k));
+        }
+        for (int i = 0; i < 12; i++) {
+            diff = orV(diff, xorV(load(rows[edgeRow[i]] + k), splat(i)));
+            diff = orV(diff, load(rows[flipRow[i]] + k));
+        }
+        mask |= zeroLanes(diff) << k;
+    }
+    return mask;
+}
+
+// Same index as CornerPatternDatabase::getDatabaseIndex: the Lehmer code of
+// the corner codes, times 2187, plus the sticker-order twists of corners
+// 0..6 in base 3. Digits and twists are computed a vector at a time.
+void CubeBatch::getCornerIndices(span<uint32_t> out) const {
+    assert(out.size() >= (size_t) LANES);
+    const array<bool, 8> &mirrored = getMirrored();
+    alignas(64) uint8_t digits[7][LANES];
+    alignas(64) uint8_t twists[7][LANES];
+    for (int k = 0; k < LANES; k += WIDTH) {
+        Vec codes[8];
+        for (int i = 0; i < 8; i++) codes[i] = load(rows[cornerRow[i]] + k);
+        for (int i = 0; i < 7; i++) {
+            // Later corners with a smaller code: greaterThan() is -1 per hit
+            Vec digit = splat(0);
+            for (int j = i + 1; j < 8; j++) digit = sub(digit, greaterThan(codes[i], codes[j]));
+            store(digits[i] + k, digit);
+
+            Vec twist = load(rows[twistRow[i]] + k);
+            if (mirrored[i]) twist = mod3(sub(splat(3), twist));
+            store(twists[i] + k, twist);
+        }
+    }
+
+    const uint32_t factorials[7] = {5040, 720, 120, 24, 6, 2, 1};
+    for (int lane = 0; lane < LANES; lane++) {
+        uint32_t rank = 0, orientation = 0;
+        for (int i = 0; i < 7; i++) {
+            rank += digits[i][lane] * factorials[i];
+            orientation = orientation * 3 + twists[i][lane];
+        }
+        out[lane] = rank * 2187 + orientation;
+    }
+}
@@ -0,0 +1,254 @@
+#include "CubieCube.h"
+
+namespace {
+    // Corner code (see RubiksCube::getCornerIndex) of the cubie whose home is
+    // each position. The mapping is its own inverse.
+    const uint8_t homeCode[8] = {0, 1, 3, 2, 4, 5, 6, 7};
+
+    // Positions whose sticker order (U/D, F/B, L/R) runs against the common
+    // handedness; their twist is mirrored when converting.
+    const bool mirrored[8] = {false, true, false, true, true, false, false, true};
+
+    // Clockwise quarter turns in MOVE order: L, R, U, D, F, B
+    const uint8_t faceCp[6][8] = {
+        {0, 2, 7, 3, 4, 1, 6, 5},
+        {4, 1, 2, 0, 6, 5, 3, 7},
+        {3, 0, 1, 2, 4, 5, 6, 7},
+        {0, 1, 2, 3, 5, 7, 4, 6},
+        {1, 5, 2, 3, 0, 4, 6, 7},
+        {0, 1, 3, 6, 4, 5, 7, 2},
+    };
+    const uint8_t faceCo[6][8] = {
+        {0, 2, 1, 0, 0, 1, 0, 2},
+        {1, 0, 0, 2, 2, 0, 1, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0},
+        {2, 1, 0, 0, 1, 2, 0, 0},
+        {0, 0, 2, 1, 0, 0, 2, 1},
+    };
+
+    array<CornerCubies, 18> buildCornerMoves() {
+        array<CornerCubies, 18> moves;
+        for (int face = 0; face < 6; face++) {
+            CornerCubies quarter;
+            for (int i = 0; i < 8; i++) {
+                quarter.cp[i] = faceCp[face][i];
+                quarter.co[i] = faceCo[face][i];
+            }
+            CornerCubies half = CornerCubies::multiply(quarter, quarter);
+            moves[face * 3] = quarter;
+            moves[face * 3 + 1] = CornerCubies::multiply(half, quarter);
+            moves[face * 3 + 2] = half;
+        }
+        return moves;
+    }
+}
+
+CornerCubies::CornerCubies() {
+    for (uint8_t i = 0; i < 8; i++) {
+        cp[i] = i;
+        co[i] = 0;
+    }
+}
+
+// Read cubies and twists from the cube's sticker colors
+CornerCubies CornerCubies::fromCube(const RubiksCube &cube) {
+    CornerCubies corners;
+    for (uint8_t i = 0; i < 8; i++) {
+        uint8_t ori = cube.getCornerOrientation(i);
+        corners.cp[i] = homeCode[cube.getCornerIndex(i)];
+        corners.co[i] = mirrored[i] ? (3 - ori) % 3 : ori;
+    }
+    return corners;
+}
+
+const CornerCubies& CornerCubies::getMove(RubiksCube::MOVE move) {
+    static const array<CornerCubies, 18> moves = buildCornerMoves();
+    return moves[(int) move];
+}
+
+// The cubie at position i after b came from position b.cp[i] after a
+CornerCubies CornerCubies::multiply(const CornerCubies &a, const CornerCubies &b) {
+    CornerCubies res;
+    for (int i = 0; i < 8; i++) {
+        res.cp[i] = a.cp[b.cp[i]];
+        res.co[i] = (a.co[b.cp[i]] + b.co[i]) % 3;
+    }
+    return res;
+}
+
+CornerCubies& CornerCubies::move(RubiksCube::MOVE move) {
+    *this = multiply(*this, getMove(move));
+    return *this;
+}
+
+CornerCubies CornerCubies::inverse() const {
+    CornerCubies inv;
+    for (int i = 0; i < 8; i++) {
+        inv.cp[cp[i]] = i;
+        inv.co[cp[i]] = (3 - co[i]) % 3;
+    }
+    return inv;
+}
+
+uint8_t CornerCubies::getCornerIndex(uint8_t ind) const {
+    return homeCode[cp[ind]];
+}
+
+// The code table is its own inverse
+void CornerCubies::setCornerIndex(uint8_t ind, uint8_t code) {
+    cp[ind] = homeCode[code];
+}
+
+uint8_t CornerCubies::getCornerOrientation(uint8_t ind) const {
+    return mirrored[ind] ? (3 - co[ind]) % 3 : co[ind];
+}
+
+bool CornerCubies::operator==(const CornerCubies &other) const {
+    return cp == other.cp && co == other.co;
+}
+
+namespace {
+    // Clockwise quarter turns in MOVE order: L, R, U, D, F, B
+    const uint8_t faceEp[6][12] = {
+        {0, 6, 2, 3, 4, 1, 9, 7, 8, 5, 10, 11},
+        {0, 1, 2, 4, 11, 5, 6, 3, 8, 9, 10, 7},
+        {3, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10, 11},
+        {0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 8},
+        {5, 1, 2, 3, 0, 8, 6, 7, 4, 9, 10, 11},
+        {0, 1, 7, 3, 4, 5, 2, 10, 8, 9, 6, 11},
+    };
+    const uint8_t faceEo[6][12] = {
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {1, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0},
+        {0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 1, 0},
+    };
+
+    array<EdgeCubies, 18> buildEdgeMoves() {
+        array<EdgeCubies, 18> moves;
+        for (int face = 0; face < 6; face++) {
+            EdgeCubies quarter;
+            for (int i = 0; i < 12; i++) {
+                quarter.ep[i] = faceEp[face][i];
+                quarter.eo[i] = faceEo[face][i];
+            }
+            EdgeCubies half = EdgeCubies::multiply(quarter, quarter);
+            moves[face * 3] = quarter;
+            moves[face * 3 + 1] = EdgeCubies::multiply(half, quarter);
+            moves[face * 3 + 2] = half;
+        }
+        return moves;
+    }
+}
+
+EdgeCubies::EdgeCubies() {
+    for (uint8_t i = 0; i < 12; i++) {
+        ep[i] = i;
+        eo[i] = 0;
+    }
+}
+
+EdgeCubies EdgeCubies::fromCube(const RubiksCube &cube) {
+    EdgeCubies edges;
+    for (uint8_t i = 0; i < 12; i++) {
+        edges.ep[i] = cube.getEdgeIndex(i);
+        edges.eo[i] = cube.getEdgeOrientation(i);
+    }
+    return edges;
+}
+
+const EdgeCubies& EdgeCubies::getMove(RubiksCube::MOVE move) {
+    static const array<EdgeCubies, 18> moves = buildEdgeMoves();
+    return moves[(int) move];
+}
+
+EdgeCubies EdgeCubies::multiply(const EdgeCubies &a, const EdgeCubies &b) {
+    EdgeCubies res;
+    for (int i = 0; i < 12; i++) {
+        res.ep[i] = a.ep[b.ep[i]];
+        res.eo[i] = a.eo[b.ep[i]] ^ b.eo[i];
+    }
+    return res;
+}
+
+EdgeCubies& EdgeCubies::move(RubiksCube::MOVE move) {
+    *this = multiply(*this, getMove(move));
+    return *this;
+}
+
+bool EdgeCubies::operator==(const EdgeCubies &other) const {
+    return ep == other.ep && eo == other.eo;
+}
+
+CubieCube CubieCube::fromCube(const RubiksCube &cube) {
+    return {CornerCubies::fromCube(cube), EdgeCubies::fromCube(cube)};
+}
+
+CubieCube& CubieCube::move(RubiksCube::MOVE move) {
+    corners.move(move);
+    edges.move(move);
+    return *this;
+}
+
+bool CubieCube::isSolved() const {
+    return *this == CubieCube();
+}
+
+namespace {
+    // 0 for even, 1 for odd; -1 if p is not a permutation of 0..n-1
+    template<size_t N>
+    int getParity(const array<uint8_t, N> &p) {
+        array<bool, N> used{};
+        for (uint8_t v : p) {
+            if (v >= N || used[v]) return -1;
+            used[v] = true;
+        }
+        int parity = 0;
+        for (size_t i = 0; i < N; i++)
+            for (size_t j = i + 1; j < N; j++)
+                parity ^= p[i] > p[j];
+        return parity;
+    }
+}
+
+bool CubieCube::isSolvable() const {
+    int cornerParity = getParity(corners.cp), edgeParity = getParity(edges.ep);
+    if (cornerParity < 0 || cornerParity != edgeParity) return false;
+    int twist = 0, flip = 0;
+    for (uint8_t co : corners.co) twist += co;
+    for (uint8_t eo : edges.eo) flip += eo;
+    return twist % 3 == 0 && flip % 2 == 0;
+}
+
+CubeKey CubieCube::getKey() const {
+    CubeKey key{0, 0};
+    for (int i = 0; i < 12; i++) {
+        key.lo |= (uint64_t) edges.ep[i] << (4 * i);
+        key.lo |= (uint64_t) edges.eo[i] << (48 + i);
+    }
+    for (int i = 0; i < 8; i++) {
+        key.hi |= (uint64_t) corners.cp[i] << (3 * i);
+        key.hi |= (uint64_t) corners.co[i] << (24 + 2 * i);
+    }
+    return key;
+}
+
+CubieCube CubieCube::fromKey(const CubeKey &key) {
+    CubieCube cube;
+    for (int i = 0; i < 12; i++) {
+        cube.edges.ep[i] = (key.lo >> (4 * i)) & 15;
+        cube.edges.eo[i] = (key.lo >> (48 + i)) & 1;
+    }
+    for (int i = 0; i < 8; i++) {
+        cube.corners.cp[i] = (key.hi >> (3 * i)) & 7;
+        cube.corners.co[i] = (key.hi >> (24 + 2 * i)) & 3;
+    }
+    return cube;
+}
+
+bool CubieCube::operator==(const CubieCube &other) const {
+    return corners == other.corners && edges == other.edges;
+}
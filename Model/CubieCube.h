@@ -0,0 +1,108 @@
+#ifndef RUBIKS_CUBE_SOLVER_CUBIECUBE_H
+#define RUBIKS_CUBE_SOLVER_CUBIECUBE_H
+
+#include <bits/stdc++.h>
+#include "RubiksCube.h"
+using namespace std;
+
+// Cubie-level view of the eight corners.
+// Positions follow getCornerColorString(): 0 UFR, 1 UFL, 2 UBL, 3 UBR,
+// 4 DFR, 5 DFL, 6 DBR, 7 DBL.
+// cp[i] is the home position of the cubie sitting at position i, and co[i]
+// its twist (0..2). Twists use one handedness for every position, so they
+// compose additively; getCornerOrientation() converts back to the
+// sticker-order convention used by the sticker models.
+struct CornerCubies {
+    array<uint8_t, 8> cp;
+    array<uint8_t, 8> co;
+
+    // Solved corners
+    CornerCubies();
+
+    // Read the corners of any cube model
+    static CornerCubies fromCube(const RubiksCube &cube);
+
+    // Corner effect of a single move
+    static const CornerCubies& getMove(RubiksCube::MOVE move);
+
+    // Apply a then b
+    static CornerCubies multiply(const CornerCubies &a, const CornerCubies &b);
+
+    // Apply a move in place
+    CornerCubies& move(RubiksCube::MOVE move);
+
+    // The corners of the inverse cube: the position where each cubie sits
+    // here becomes the home it is sent to there, with the twist undone
+    CornerCubies inverse() const;
+
+    // Same values as RubiksCube::getCornerIndex / getCornerOrientation
+    uint8_t getCornerIndex(uint8_t ind) const;
+    uint8_t getCornerOrientation(uint8_t ind) const;
+
+    // Place the cubie with corner code (as getCornerIndex) at position ind
+    void setCornerIndex(uint8_t ind, uint8_t code);
+
+    bool operator==(const CornerCubies &other) const;
+};
+
+// Cubie-level view of the twelve edges, positions as in
+// getEdgeColorString(). ep[i] is the home position of the cubie at i and
+// eo[i] its flip (0/1), with the same conventions as CornerCubies.
+struct EdgeCubies {
+    array<uint8_t, 12> ep;
+    array<uint8_t, 12> eo;
+
+    // Solved edges
+    EdgeCubies();
+
+    // Read the edges of any cube model
+    static EdgeCubies fromCube(const RubiksCube &cube);
+
+    // Edge effect of a single move
+    static const EdgeCubies& getMove(RubiksCube::MOVE move);
+
+    // Apply a then b
+    static EdgeCubies multiply(const EdgeCubies &a, const EdgeCubies &b);
+
+    // Apply a move in place
+    EdgeCubies& move(RubiksCube::MOVE move);
+
+    bool operator==(const EdgeCubies &other) const;
+};
+
+// Whole cube state in 100 bits: every cubie's home position and twist/flip.
+// lo holds the edges (4 bits of position each, then 12 flip bits), hi the
+// corners (3 bits of position each, then 2 bits of twist each); the bits
+// above 40 in hi are always zero.
+struct CubeKey {
+    uint64_t lo;
+    uint64_t hi;
+
+    bool operator==(const CubeKey &other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+};
+
+// Full cubie model: corners and edges.
+struct CubieCube {
+    CornerCubies corners;
+    EdgeCubies edges;
+
+    // Read any cube model
+    static CubieCube fromCube(const RubiksCube &cube);
+
+    CubieCube& move(RubiksCube::MOVE move);
+
+    bool isSolved() const;
+
+    // Reachable by moves: proper permutations of equal parity, twists
+    // summing to 0 mod 3 and an even number of flipped edges
+    bool isSolvable() const;
+
+    CubeKey getKey() const;
+    static CubieCube fromKey(const CubeKey &key);
+
+    bool operator==(const CubieCube &other) const;
+};
+
+#endif // RUBIKS_CUBE_SOLVER_CUBIECUBE_H
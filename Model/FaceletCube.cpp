@@ -0,0 +1,195 @@
+#include "FaceletCube.h"
+
+namespace {
+    struct Vec {
+        int x, y, z;
+        bool operator==(const Vec &o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+
+    // Outward normal of each face, in FACE order (x: L->R, y: D->U, z: B->F)
+    const Vec normals[6] = {
+        {0, 1, 0}, {-1, 0, 0}, {0, 0, 1}, {1, 0, 0}, {0, 0, -1}, {0, -1, 0}
+    };
+
+    // Cubie position of sticker (face, row, col), matching the net that
+    // print() and getCornerColorString() use
+    Vec getPosition(int face, int row, int col) {
+        switch (face) {
+            case 0:  return {col - 1, 1, row - 1};
+            case 1:  return {-1, 1 - row, col - 1};
+            case 2:  return {col - 1, 1 - row, 1};
+            case 3:  return {1, 1 - row, 1 - col};
+            case 4:  return {1 - col, 1 - row, -1};
+            default: return {col - 1, -1, 1 - row};
+        }
+    }
+
+    // Lookup tables derived once from the geometry above
+    struct Geometry {
+        uint8_t faceletMap[48][54];      // where each sticker goes
+        uint8_t faceMap[48][6];          // where each face (and color) goes
+        uint8_t moveMap[48][18];
+        uint8_t inverseSym[48];
+        vector<vector<uint8_t>> cubies;  // facelets of each edge and corner
+        uint8_t homeFacelet[64][6];      // [color set][color] -> facelet
+
+        Geometry() {
+            Vec pos[54], nrm[54];
+            for (int f = 0; f < 54; f++) {
+                pos[f] = getPosition(f / 9, f / 3 % 3, f % 3);
+                nrm[f] = normals[f / 9];
+            }
+
+            // Group stickers by cubie; centers are fixed and left out
+            for (int f = 0; f < 54; f++) {
+                if (f % 9 == 4) continue;
+                bool placed = false;
+                for (auto &cubie : cubies) {
+                    if (pos[cubie[0]] == pos[f]) {
+                        cubie.push_back(f);
+                        placed = true;
+                    }
+                }
+                if (!placed) cubies.push_back({(uint8_t) f});
+            }
+            for (auto &cubie : cubies) {
+                int mask = 0;
+                for (uint8_t f : cubie) mask |= 1 << (f / 9);
+                for (uint8_t f : cubie) homeFacelet[mask][f / 9] = f;
+            }
+
+            // Signed axis permutations: axis i of the image is
+            // sign[i] * axis perm[i] of the original
+            const int perms[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2},
+                                     {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+            const int permParity[6] = {1, -1, -1, 1, 1, -1};
+            for (int sym = 0; sym < 48; sym++) {
+                const int *perm = perms[sym / 8];
+                int sign[3], det = permParity[sym / 8];
+                for (int i = 0; i < 3; i++) {
+                    sign[i] = (sym >> i) & 1 ? -1 : 1;
+                    det *= sign[i];
+                }
+                auto apply = [&](const Vec &v) {
+                    int in[3] = {v.x, v.y, v.z};
+                    return Vec{sign[0] * in[perm[0]], sign[1] * in[perm[1]], sign[2] * in[perm[2]]};
+                };
+
+                for (int f = 0; f < 54; f++) {
+                    Vec p = apply(pos[f]), n = apply(nrm[f]);
+                    for (int g = 0; g < 54; g++) {
+                        if (pos[g] == p && nrm[g] == n) faceletMap[sym][f] = g;
+                    }
+                }
+                for (int face = 0; face < 6; face++) {
+                    faceMap[sym][face] = faceletMap[sym][face * 9 + 4] / 9;
+                }
+                // Moves are grouped by face in MOVE order L, R, U, D, F, B
+                const int moveFace[6] = {1, 3, 0, 5, 2, 4};
+                int faceMoves[6];
+                for (int i = 0; i < 6; i++) faceMoves[moveFace[i]] = i;
+                for (int m = 0; m < 18; m++) {
+                    int turn = m % 3;
+                    if (det < 0 && turn != 2) turn = 1 - turn;
+                    moveMap[sym][m] = faceMoves[faceMap[sym][moveFace[m / 3]]] * 3 + turn;
+                }
+            }
+            for (int sym = 0; sym < 48; sym++) {
+                for (int other = 0; other < 48; other++) {
+                    bool identity = true;
+                    for (int f = 0; f < 54; f++) {
+                        identity &= faceletMap[other][faceletMap[sym][f]] == f;
+                    }
+                    if (identity) inverseSym[sym] = other;
+                }
+            }
+        }
+    };
+
+    const Geometry& getGeometry() {
+        static const Geometry geometry;
+        return geometry;
+    }
+}
+
+FaceletCube::FaceletCube() {
+    for (int f = 0; f < 54; f++) facelets[f] = f / 9;
+}
+
+FaceletCube FaceletCube::fromCube(const RubiksCube &cube) {
+    FaceletCube res;
+    for (int f = 0; f < 54; f++) {
+        res.facelets[f] = (uint8_t) cube.getColor(RubiksCube::FACE(f / 9), f / 3 % 3, f % 3);
+    }
+    return res;
+}
+
+bool FaceletCube::fromString(const string &str, FaceletCube &cube) {
+    if (str.size() != 54) return false;
+    for (int f = 0; f < 54; f++) {
+        int color = 0;
+        while (color < 6 && RubiksCube::getColorLetter(RubiksCube::COLOR(color)) != str[f]) color++;
+        if (color == 6) return false;
+        cube.facelets[f] = color;
+    }
+    return true;
+}
+
+string FaceletCube::toString() const {
+    string str;
+    for (uint8_t color : facelets) str += RubiksCube::getColorLetter(RubiksCube::COLOR(color));
+    return str;
+}
+
+bool FaceletCube::isValid() const {
+    for (int face = 0; face < 6; face++) {
+        if (facelets[face * 9 + 4] != face) return false;
+    }
+    const Geometry &geo = getGeometry();
+    vector<int> homeMasks, seen;
+    for (const auto &cubie : geo.cubies) {
+        int home = 0, mask = 0;
+        for (uint8_t f : cubie) {
+            home |= 1 << (f / 9);
+            mask |= 1 << facelets[f];
+        }
+        homeMasks.push_back(home);
+        seen.push_back(mask);
+    }
+    sort(homeMasks.begin(), homeMasks.end());
+    sort(seen.begin(), seen.end());
+    return homeMasks == seen;
+}
+
+FaceletCube FaceletCube::conjugate(int sym) const {
+    const Geometry &geo = getGeometry();
+    FaceletCube res;
+    for (int f = 0; f < 54; f++) {
+        res.facelets[geo.faceletMap[sym][f]] = geo.faceMap[sym][facelets[f]];
+    }
+    return res;
+}
+
+RubiksCube::MOVE FaceletCube::getSymmetricMove(RubiksCube::MOVE move, int sym) {
+    return RubiksCube::MOVE(getGeometry().moveMap[sym][(int) move]);
+}
+
+int FaceletCube::getInverseSymmetry(int sym) {
+    return getGeometry().inverseSym[sym];
+}
+
+// Each cubie's colors name the cubie, and each sticker's color names its
+// home sticker. The inverse puts, at that home, the color of the place the
+// sticker currently sits.
+FaceletCube FaceletCube::inverse() const {
+    const Geometry &geo = getGeometry();
+    FaceletCube res;
+    for (const auto &cubie : geo.cubies) {
+        int mask = 0;
+        for (uint8_t f : cubie) mask |= 1 << facelets[f];
+        for (uint8_t f : cubie) {
+            res.facelets[geo.homeFacelet[mask][facelets[f]]] = f / 9;
+        }
+    }
+    return res;
+}
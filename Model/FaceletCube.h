@@ -0,0 +1,68 @@
+#ifndef RUBIKS_CUBE_SOLVER_FACELETCUBE_H
+#define RUBIKS_CUBE_SOLVER_FACELETCUBE_H
+
+#include <bits/stdc++.h>
+#include "RubiksCube.h"
+using namespace std;
+
+// Facelet-level view of a cube: 54 sticker colors, stored as the index of
+// the face that color belongs to (face * 9 + row * 3 + col, same layout as
+// getColor()). Works with every model and is the common ground for
+// symmetry and inversion, which are awkward at the sticker-model level.
+class FaceletCube {
+public:
+    array<uint8_t, 54> facelets;
+
+    // Solved cube
+    FaceletCube();
+
+    // Read all stickers of a cube
+    static FaceletCube fromCube(const RubiksCube &cube);
+
+    // Text form: 54 color letters (see getColorLetter), face by face in
+    // FACE order, each face row by row as print() lays it out. fromString
+    // returns false on a malformed string; it does not check solvability.
+    static bool fromString(const string &str, FaceletCube &cube);
+    string toString() const;
+
+    // Centers in place and every edge and corner a real, distinct cubie.
+    // Twist, flip and parity are left to CubieCube::isSolvable().
+    bool isValid() const;
+
+    // Number of whole-cube symmetries: 24 rotations and their mirror images
+    static const int NUM_SYMMETRIES = 48;
+
+    // The cube seen through symmetry sym: every sticker moved by the
+    // rotation/reflection and recolored so the centers stay in place.
+    // If a sequence solves this cube, mapping each move with getSymmetricMove
+    // gives a sequence that solves the conjugated cube.
+    FaceletCube conjugate(int sym) const;
+
+    // How a move looks after symmetry sym; reflections reverse turn
+    // directions
+    static RubiksCube::MOVE getSymmetricMove(RubiksCube::MOVE move, int sym);
+
+    // The symmetry that undoes sym
+    static int getInverseSymmetry(int sym);
+
+    // The inverse cube: if sequence S turns solved into this cube, the
+    // result is the cube that S turns back into solved
+    FaceletCube inverse() const;
+
+    bool operator==(const FaceletCube &other) const {
+        return facelets == other.facelets;
+    }
+
+    bool operator<(const FaceletCube &other) const {
+        return facelets < other.facelets;
+    }
+};
+
+// Hash functor for unordered_map keys
+struct HashFacelet {
+    size_t operator()(const FaceletCube &c) const {
+        return hash<string_view>()(string_view(reinterpret_cast<const char*>(c.facelets.data()), 54));
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_FACELETCUBE_H
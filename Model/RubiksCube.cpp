@@ -42,6 +42,23 @@ string RubiksCube::getMove(MOVE ind) {
     }
 }
 
+bool RubiksCube::parseMove(const string &str, MOVE &move) {
+    for (int m = 0; m < 18; m++) {
+        if (getMove(MOVE(m)) == str) {
+            move = MOVE(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Quarter turns swap with their primes; half turns undo themselves.
+RubiksCube::MOVE RubiksCube::getInverseMove(MOVE ind) {
+    int face = (int) ind / 3;
+    int turn = (int) ind % 3;
+    return MOVE(face * 3 + (turn == 2 ? 2 : 1 - turn));
+}
+
 // Apply the given move to this cube.
 RubiksCube& RubiksCube::move(MOVE ind) {
     switch (ind) {
@@ -263,4 +280,48 @@ uint8_t RubiksCube::getCornerOrientation(uint8_t ind) const {
     }
     // Otherwise orientation 0
     return 0;
-}
\ No newline at end of file
+}
+// Stickers of each edge position as {face, row, col}, in the order used by
+// getEdgeColorString().
+static const uint8_t edgeStickers[12][2][3] = {
+    {{0, 2, 1}, {2, 0, 1}},  // U-F
+    {{0, 1, 0}, {1, 0, 1}},  // U-L
+    {{0, 0, 1}, {4, 0, 1}},  // U-B
+    {{0, 1, 2}, {3, 0, 1}},  // U-R
+    {{2, 1, 2}, {3, 1, 0}},  // F-R
+    {{2, 1, 0}, {1, 1, 2}},  // F-L
+    {{4, 1, 2}, {1, 1, 0}},  // B-L
+    {{4, 1, 0}, {3, 1, 2}},  // B-R
+    {{5, 0, 1}, {2, 2, 1}},  // D-F
+    {{5, 1, 0}, {1, 2, 1}},  // D-L
+    {{5, 2, 1}, {4, 2, 1}},  // D-B
+    {{5, 1, 2}, {3, 2, 1}},  // D-R
+};
+
+string RubiksCube::getEdgeColorString(uint8_t ind) const {
+    string str;
+    for (auto &s : edgeStickers[ind]) {
+        str += getColorLetter(getColor(FACE(s[0]), s[1], s[2]));
+    }
+    return str;
+}
+
+// Match the edge's pair of colors against the solved colors of each position.
+// Colors share their numbering with the faces they belong to when solved.
+uint8_t RubiksCube::getEdgeIndex(uint8_t ind) const {
+    auto &s = edgeStickers[ind];
+    int a = (int) getColor(FACE(s[0][0]), s[0][1], s[0][2]);
+    int b = (int) getColor(FACE(s[1][0]), s[1][1], s[1][2]);
+    for (uint8_t i = 0; i < 12; i++) {
+        int x = edgeStickers[i][0][0], y = edgeStickers[i][1][0];
+        if ((a == x && b == y) || (a == y && b == x)) return i;
+    }
+    return 0;
+}
+
+uint8_t RubiksCube::getEdgeOrientation(uint8_t ind) const {
+    auto &s = edgeStickers[ind];
+    int a = (int) getColor(FACE(s[0][0]), s[0][1], s[0][2]);
+    // The first-listed face of the cubie's home holds its primary color
+    return a == edgeStickers[getEdgeIndex(ind)][0][0] ? 0 : 1;
+}
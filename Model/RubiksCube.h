@@ -47,6 +47,12 @@ public:
     // Convert a MOVE to its string (e.g., "U", "R'", "F2").
     static string getMove(MOVE move);
 
+    // Parse the output of getMove() back; false if str is not a move.
+    static bool parseMove(const string &str, MOVE &move);
+
+    // The move that undoes move (e.g., R' for R, F2 for F2).
+    static MOVE getInverseMove(MOVE move);
+
     // Display the cube in a flat net layout.
     void print() const;
 
@@ -79,10 +85,21 @@ public:
     virtual RubiksCube& bPrime() = 0;
     virtual RubiksCube& b2() = 0;
 
-    // Corner utilities.
+    // Corner utilities. Index and orientation read the colors through
+    // getColor(); models may override them with a faster path.
     string getCornerColorString(uint8_t index) const;
-    uint8_t getCornerIndex(uint8_t index) const;
-    uint8_t getCornerOrientation(uint8_t index) const;
+    virtual uint8_t getCornerIndex(uint8_t index) const;
+    virtual uint8_t getCornerOrientation(uint8_t index) const;
+
+    // Edge utilities. Positions: 0 UF, 1 UL, 2 UB, 3 UR, 4 FR, 5 FL, 6 BL,
+    // 7 BR, 8 DF, 9 DL, 10 DB, 11 DR; stickers listed U/D face first, else
+    // F/B face first.
+    string getEdgeColorString(uint8_t index) const;
+    // Home position (0..11) of the edge cubie at index.
+    virtual uint8_t getEdgeIndex(uint8_t index) const;
+    // 0 if the cubie's U/D color (F/B color for slice edges) sits in the
+    // first sticker of the position, else 1.
+    virtual uint8_t getEdgeOrientation(uint8_t index) const;
 };
 
 #endif // RUBIKS_CUBE_SOLVER_RUBIKSCUBE_H
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "RubiksCube2x2.h"
+
+namespace {
+    // {face, row, col} of each corner position's stickers, in the order of
+    // RubiksCube::getCornerColorString(): U/D face, F/B face, L/R face
+    const uint8_t cornerStickers[8][3][3] = {
+        {{0, 1, 1}, {2, 0, 1}, {3, 0, 0}},  // U-F-R
+        {{0, 1, 0}, {2, 0, 0}, {1, 0, 1}},  // U-F-L
+        {{0, 0, 0}, {4, 0, 1}, {1, 0, 0}},  // U-B-L
+        {{0, 0, 1}, {4, 0, 0}, {3, 0, 1}},  // U-B-R
+        {{5, 0, 1}, {2, 1, 1}, {3, 1, 0}},  // D-F-R
+        {{5, 0, 0}, {2, 1, 0}, {1, 1, 1}},  // D-F-L
+        {{5, 1, 1}, {4, 1, 0}, {3, 1, 1}},  // D-B-R
+        {{5, 1, 0}, {4, 1, 1}, {1, 1, 0}},  // D-B-L
+    };
+
+    struct Layout {
+        // Corner position and sticker of each (face, row, col)
+        uint8_t position[6][2][2];
+        uint8_t sticker[6][2][2];
+        // Stickers of each position in the common twist direction (see
+        // CornerCubies): sticker order, or its mirror image
+        uint8_t turn[8][3];
+        // Bit per face of each cubie's colors
+        uint8_t colorMask[8];
+
+        Layout() {
+            for (int i = 0; i < 8; i++) {
+                colorMask[i] = 0;
+                for (int s = 0; s < 3; s++) {
+                    const uint8_t *st = cornerStickers[i][s];
+                    position[st[0]][st[1]][st[2]] = i;
+                    sticker[st[0]][st[1]][st[2]] = s;
+                    colorMask[i] |= 1 << st[0];
+                }
+                CornerCubies probe;
+                probe.co[i] = 1;
+                bool mirrored = probe.getCornerOrientation(i) == 2;
+                turn[i][0] = 0;
+                turn[i][1] = mirrored ? 2 : 1;
+                turn[i][2] = mirrored ? 1 : 2;
+            }
+        }
+    };
+
+    const Layout& getLayout() {
+        static const Layout layout;
+        return layout;
+    }
+}
+
+RubiksCube2x2 RubiksCube2x2::fromCube(const RubiksCube &cube) {
+    RubiksCube2x2 res;
+    res.corners = CornerCubies::fromCube(cube);
+    return res;
+}
+
+// Each corner's twist is where its U/D color sits, in the sticker order
+// of its position; its cubie is the one with the same set of colors
+bool RubiksCube2x2::fromString(const string &str, RubiksCube2x2 &cube) {
+    if (str.size() != 24) return false;
+    const string letters = "WGRBOY";
+    const Layout &layout = getLayout();
+    CornerCubies corners;
+    uint8_t used = 0;
+    int twist = 0;
+    for (int i = 0; i < 8; i++) {
+        uint8_t mask = 0;
+        int udSticker = -1;
+        for (int s = 0; s < 3; s++) {
+            const uint8_t *st = cornerStickers[i][s];
+            size_t color = letters.find(str[st[0] * 4 + st[1] * 2 + st[2]]);
+            if (color == string::npos) return false;
+            mask |= 1 << color;
+            if (color == 0 || color == 5) udSticker = s;
+        }
+        int home = find(layout.colorMask, layout.colorMask + 8, mask) - layout.colorMask;
+        if (home == 8 || (used >> home & 1)) return false;
+        used |= 1 << home;
+        corners.cp[i] = home;
+        corners.co[i] = find(layout.turn[i], layout.turn[i] + 3, udSticker) - layout.turn[i];
+        twist += corners.co[i];
+    }
+    if (twist % 3 != 0) return false;
+    cube.corners = corners;
+    return true;
+}
+
+string RubiksCube2x2::toString() const {
+    string str;
+    for (int face = 0; face < 6; face++)
+        for (unsigned row = 0; row < 2; row++)
+            for (unsigned col = 0; col < 2; col++)
+                str += RubiksCube::getColorLetter(getColor(FACE(face), row, col));
+    return str;
+}
+
+// The cubie at the sticker's position keeps its colors in the common twist
+// direction, turned by its twist
+RubiksCube2x2::COLOR RubiksCube2x2::getColor(FACE face, unsigned row, unsigned col) const {
+    const Layout &layout = getLayout();
+    int f = (int) face;
+    uint8_t i = layout.position[f][row][col];
+    const uint8_t *turn = layout.turn[i];
+    int k = find(turn, turn + 3, layout.sticker[f][row][col]) - turn;
+    uint8_t home = corners.cp[i];
+    uint8_t homeSticker = layout.turn[home][(k - corners.co[i] + 3) % 3];
+    return (COLOR) cornerStickers[home][homeSticker][0];
+}
+
+bool RubiksCube2x2::isSolved() const {
+    for (int face = 0; face < 6; face++) {
+        COLOR color = getColor(FACE(face), 0, 0);
+        if (getColor(FACE(face), 0, 1) != color || getColor(FACE(face), 1, 0) != color ||
+            getColor(FACE(face), 1, 1) != color)
+            return false;
+    }
+    return true;
+}
+
+RubiksCube2x2& RubiksCube2x2::move(MOVE move) {
+    corners.move(move);
+    return *this;
+}
+
+RubiksCube2x2& RubiksCube2x2::invert(MOVE move) {
+    corners.move(RubiksCube::getInverseMove(move));
+    return *this;
+}
+
+vector<RubiksCube::MOVE> RubiksCube2x2::randomShuffleCube(unsigned int times) {
+    vector<MOVE> moves_performed;
+    srand(static_cast<unsigned>(time(nullptr)));
+    for (unsigned int i = 0; i < times; i++) {
+        MOVE m = static_cast<MOVE>(rand() % 18);
+        moves_performed.push_back(m);
+        this->move(m);
+    }
+    return moves_performed;
+}
+
+void RubiksCube2x2::print() const {
+    cout << "Rubik's Cube 2x2:\n\n";
+    auto printRow = [&](FACE face, int row) {
+        for (int col = 0; col < 2; col++) cout << RubiksCube::getColorLetter(getColor(face, row, col)) << " ";
+    };
+
+    for (int row = 0; row < 2; row++) {
+        cout << "      ";
+        printRow(FACE::UP, row);
+        cout << "\n";
+    }
+    cout << "\n";
+    for (int row = 0; row < 2; row++) {
+        for (FACE face : {FACE::LEFT, FACE::FRONT, FACE::RIGHT, FACE::BACK}) {
+            printRow(face, row);
+            cout << " ";
+        }
+        cout << "\n";
+    }
+    cout << "\n";
+    for (int row = 0; row < 2; row++) {
+        cout << "      ";
+        printRow(FACE::DOWN, row);
+        cout << "\n";
+    }
+    cout << "\n";
+}
+
+// Closure of the quarter rotations about x (R with L') and y (U with D')
+const array<CornerCubies, 24>& RubiksCube2x2::getRotations() {
+    static const array<CornerCubies, 24> rotations = [] {
+        CornerCubies x = CornerCubies::getMove(MOVE::R), y = CornerCubies::getMove(MOVE::U);
+        x.move(MOVE::LPRIME);
+        y.move(MOVE::DPRIME);
+        vector<CornerCubies> found = {CornerCubies()};
+        for (size_t i = 0; i < found.size(); i++) {
+            for (const CornerCubies &turn : {x, y}) {
+                CornerCubies next = CornerCubies::multiply(found[i], turn);
+                if (find(found.begin(), found.end(), next) == found.end()) found.push_back(next);
+            }
+        }
+        assert(found.size() == 24);
+        array<CornerCubies, 24> res;
+        copy(found.begin(), found.end(), res.begin());
+        return res;
+    }();
+    return rotations;
+}
@@ -0,0 +1,59 @@
+#ifndef RUBIKS_CUBE_SOLVER_RUBIKSCUBE2X2_H
+#define RUBIKS_CUBE_SOLVER_RUBIKSCUBE2X2_H
+
+#include <bits/stdc++.h>
+#include "RubiksCube.h"
+#include "CubieCube.h"
+using namespace std;
+
+// 2x2x2 cube: the eight corners of a 3x3 and nothing else, held as
+// CornerCubies. Moves and colors follow RubiksCube, with each face 2x2:
+// (row, col) of a face is (row * 2, col * 2) of the 3x3 net. Without
+// centers there is no fixed frame, so the cube is solved with each face
+// one color, in any of the 24 orientations.
+class RubiksCube2x2 {
+public:
+    typedef RubiksCube::FACE FACE;
+    typedef RubiksCube::COLOR COLOR;
+    typedef RubiksCube::MOVE MOVE;
+
+    CornerCubies corners;
+
+    // Solved cube
+    RubiksCube2x2() = default;
+
+    // The corners of a 3x3 model
+    static RubiksCube2x2 fromCube(const RubiksCube &cube);
+
+    // Text form: 24 color letters (see RubiksCube::getColorLetter), face by
+    // face in FACE order, each face row by row as print() lays it out. The
+    // cube may be held any way up. fromString returns false unless every
+    // corner is a distinct real cubie and the twists add up.
+    static bool fromString(const string &str, RubiksCube2x2 &cube);
+    string toString() const;
+
+    // Color at (row, col), both 0..1, on face
+    COLOR getColor(FACE face, unsigned row, unsigned col) const;
+
+    bool isSolved() const;
+
+    RubiksCube2x2& move(MOVE move);
+    RubiksCube2x2& invert(MOVE move);
+
+    // Apply a series of random moves; returns the moves used
+    vector<MOVE> randomShuffleCube(unsigned int times);
+
+    // Display the cube in a flat net layout
+    void print() const;
+
+    // The 24 whole-cube rotations as corner states, identity first. The
+    // cube X turned by moves M shows rotation r exactly when r^-1 * X is
+    // solved by M, so a solver for the fixed frame solves all 24.
+    static const array<CornerCubies, 24>& getRotations();
+
+    bool operator==(const RubiksCube2x2 &other) const {
+        return corners == other.corners;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_RUBIKSCUBE2X2_H
@@ -28,6 +28,8 @@ public:
                     cube[f][r][c] = getColorLetter(COLOR(f));
     }
 
+    RubiksCube3dArray(const RubiksCube3dArray &other) = default;
+
     // Return the color enum at (face, row, col)
     COLOR getColor(FACE face, unsigned row, unsigned col) const override {
         char ch = cube[int(face)][row][col];
@@ -19,34 +19,49 @@ private:
     // Move three stickers from side s2 to side s1 at given indices
     void rotateSide(int s1, int s1_1, int s1_2, int s1_3,
                     int s2, int s2_1, int s2_2, int s2_3) {
-        uint64_t clr1 = (bitboard[s2] & (one_8 << (8 * s2_1))) >> (8 * s2_1);
-        uint64_t clr2 = (bitboard[s2] & (one_8 << (8 * s2_2))) >> (8 * s2_2);
-        uint64_t clr3 = (bitboard[s2] & (one_8 << (8 * s2_3))) >> (8 * s2_3);
+        rotateSide(s1, s1_1, s1_2, s1_3, bitboard[s2], s2_1, s2_2, s2_3);
+    }
+
+    // Same, reading from a saved copy of a side that was already overwritten
+    void rotateSide(int s1, int s1_1, int s1_2, int s1_3,
+                    uint64_t side2, int s2_1, int s2_2, int s2_3) {
+        uint64_t clr1 = (side2 & (one_8 << (8 * s2_1))) >> (8 * s2_1);
+        uint64_t clr2 = (side2 & (one_8 << (8 * s2_2))) >> (8 * s2_2);
+        uint64_t clr3 = (side2 & (one_8 << (8 * s2_3))) >> (8 * s2_3);
 
         bitboard[s1] = (bitboard[s1] & ~(one_8 << (8 * s1_1))) | (clr1 << (8 * s1_1));
         bitboard[s1] = (bitboard[s1] & ~(one_8 << (8 * s1_2))) | (clr2 << (8 * s1_2));
         bitboard[s1] = (bitboard[s1] & ~(one_8 << (8 * s1_3))) | (clr3 << (8 * s1_3));
     }
 
-    // Convert a 3-character corner string into a 5-bit code
-    int get5bitCorner(const string &corner) {
-        int code = 0;
-        string whiteYellow;
-        for (char c : corner) {
-            if (c == 'W' || c == 'Y') {
-                whiteYellow.push_back(c);
-                if (c == 'Y') code |= (1 << 2);
-            }
-        }
-        for (char c : corner) {
-            if (c == 'O') code |= (1 << 1);
-        }
-        for (char c : corner) {
-            if (c == 'G') code |= (1 << 0);
+    // Stickers of each corner and edge position as {face, index in the
+    // face's ring}, in getCornerColorString / getEdgeColorString order
+    static constexpr uint8_t cornerStickers[8][3][2] = {
+        {{0, 4}, {2, 2}, {3, 0}}, {{0, 6}, {2, 0}, {1, 2}},
+        {{0, 0}, {4, 2}, {1, 0}}, {{0, 2}, {4, 0}, {3, 2}},
+        {{5, 2}, {2, 4}, {3, 6}}, {{5, 0}, {2, 6}, {1, 4}},
+        {{5, 4}, {4, 6}, {3, 4}}, {{5, 6}, {4, 4}, {1, 6}},
+    };
+    static constexpr uint8_t edgeStickers[12][2][2] = {
+        {{0, 5}, {2, 1}}, {{0, 7}, {1, 1}}, {{0, 1}, {4, 1}}, {{0, 3}, {3, 1}},
+        {{2, 3}, {3, 7}}, {{2, 7}, {1, 3}}, {{4, 3}, {1, 7}}, {{4, 7}, {3, 3}},
+        {{5, 1}, {2, 5}}, {{5, 7}, {1, 5}}, {{5, 5}, {4, 5}}, {{5, 3}, {3, 5}},
+    };
+
+    // Home position of the edge with each pair of one-hot colors, ORed
+    static constexpr array<uint8_t, 64> edgeByColors = [] {
+        array<uint8_t, 64> table{};
+        for (uint8_t i = 0; i < 12; i++) {
+            table[1 << edgeStickers[i][0][0] | 1 << edgeStickers[i][1][0]] = i;
         }
-        if (corner[1] == whiteYellow[0]) code |= (1 << 3);
-        else if (corner[2] == whiteYellow[0]) code |= (1 << 4);
-        return code;
+        return table;
+    }();
+
+    static const uint64_t UD_COLORS = 1 << (int)COLOR::WHITE | 1 << (int)COLOR::YELLOW;
+
+    // One-hot color byte of a sticker
+    uint64_t getSticker(const uint8_t (&sticker)[2]) const {
+        return (bitboard[sticker[0]] >> (8 * sticker[1])) & 0xFF;
     }
 
 public:
@@ -64,18 +79,15 @@ public:
         }
     }
 
+    RubiksCubeBitboard(const RubiksCubeBitboard &other) = default;
+
     // Return the color at (face, row, col)
     COLOR getColor(FACE face, unsigned row, unsigned col) const override {
         int idx = arr[row][col];
         if (idx == 8) return (COLOR)face;
         uint64_t side = bitboard[(int)face];
         uint64_t color = (side >> (8 * idx)) & one_8;
-        int bitPos = 0;
-        while (color) {
-            color >>= 1;
-            bitPos++;
-        }
-        return (COLOR)(bitPos - 1);
+        return (COLOR)countr_zero(color);
     }
 
     // Check if each face matches its solved configuration
@@ -110,9 +122,11 @@ public:
     // L move: rotate left face and cycle its adjacent stickers
     RubiksCube& l() override {
         rotateFace(1);
+        uint64_t front = bitboard[2];
         this->rotateSide(2, 0, 7, 6, 0, 0, 7, 6);
         this->rotateSide(0, 0, 7, 6, 4, 4, 3, 2);
         this->rotateSide(4, 4, 3, 2, 5, 0, 7, 6);
+        this->rotateSide(5, 0, 7, 6, front, 0, 7, 6);
         return *this;
     }
 
@@ -129,9 +143,11 @@ public:
     // F move: rotate front face and cycle its adjacent stickers
     RubiksCube& f() override {
         rotateFace(2);
+        uint64_t up = bitboard[0];
         this->rotateSide(0, 4, 5, 6, 1, 2, 3, 4);
         this->rotateSide(1, 2, 3, 4, 5, 0, 1, 2);
         this->rotateSide(5, 0, 1, 2, 3, 6, 7, 0);
+        this->rotateSide(3, 6, 7, 0, up, 4, 5, 6);
         return *this;
     }
 
@@ -148,9 +164,11 @@ public:
     // R move: rotate right face and cycle its adjacent stickers
     RubiksCube& r() override {
         rotateFace(3);
+        uint64_t up = bitboard[0];
         this->rotateSide(0, 2, 3, 4, 2, 2, 3, 4);
         this->rotateSide(2, 2, 3, 4, 5, 2, 3, 4);
-        this->rotateSide(5, 2, 3, 4, 4, 7, 6, 0);
+        this->rotateSide(5, 2, 3, 4, 4, 6, 7, 0);
+        this->rotateSide(4, 6, 7, 0, up, 2, 3, 4);
         return *this;
     }
 
@@ -167,9 +185,11 @@ public:
     // B move: rotate back face and cycle its adjacent stickers
     RubiksCube& b() override {
         rotateFace(4);
+        uint64_t up = bitboard[0];
         this->rotateSide(0, 0, 1, 2, 3, 2, 3, 4);
         this->rotateSide(3, 2, 3, 4, 5, 4, 5, 6);
         this->rotateSide(5, 4, 5, 6, 1, 6, 7, 0);
+        this->rotateSide(1, 6, 7, 0, up, 0, 1, 2);
         return *this;
     }
 
@@ -186,9 +206,11 @@ public:
     // D move: rotate down face and cycle its adjacent stickers
     RubiksCube& d() override {
         rotateFace(5);
+        uint64_t front = bitboard[2];
         this->rotateSide(2, 4, 5, 6, 1, 4, 5, 6);
         this->rotateSide(1, 4, 5, 6, 4, 4, 5, 6);
         this->rotateSide(4, 4, 5, 6, 3, 4, 5, 6);
+        this->rotateSide(3, 4, 5, 6, front, 4, 5, 6);
         return *this;
     }
 
@@ -202,6 +224,34 @@ public:
         return *this;
     }
 
+    // Corner and edge cubies straight from the color bytes: the ORed
+    // colors of a cubie identify it, and the position of its U/D (or F/B)
+    // color gives the orientation. Same values as the RubiksCube versions.
+    uint8_t getCornerIndex(uint8_t ind) const override {
+        auto &s = cornerStickers[ind];
+        uint64_t colors = getSticker(s[0]) | getSticker(s[1]) | getSticker(s[2]);
+        return (colors >> (int)COLOR::YELLOW & 1) << 2
+             | (colors >> (int)COLOR::ORANGE & 1) << 1
+             | (colors >> (int)COLOR::GREEN & 1);
+    }
+
+    uint8_t getCornerOrientation(uint8_t ind) const override {
+        auto &s = cornerStickers[ind];
+        if (getSticker(s[1]) & UD_COLORS) return 1;
+        if (getSticker(s[2]) & UD_COLORS) return 2;
+        return 0;
+    }
+
+    uint8_t getEdgeIndex(uint8_t ind) const override {
+        auto &s = edgeStickers[ind];
+        return edgeByColors[getSticker(s[0]) | getSticker(s[1])];
+    }
+
+    uint8_t getEdgeOrientation(uint8_t ind) const override {
+        uint64_t first = getSticker(edgeStickers[ind][0]);
+        return first == 1u << edgeStickers[getEdgeIndex(ind)][0][0] ? 0 : 1;
+    }
+
     bool operator==(const RubiksCubeBitboard &other) const {
         for (int i = 0; i < 6; i++) {
             if (bitboard[i] != other.bitboard[i]) return false;
@@ -216,28 +266,16 @@ public:
         return *this;
     }
 
-    // Combine eight corners into a 40-bit value
-    uint64_t getCorners() {
-        auto getCornerStr = [&](FACE f1, int r1, int c1,
-                                FACE f2, int r2, int c2,
-                                FACE f3, int r3, int c3) {
-            string s;
-            s += getColorLetter(getColor(f1, r1, c1));
-            s += getColorLetter(getColor(f2, r2, c2));
-            s += getColorLetter(getColor(f3, r3, c3));
-            return get5bitCorner(s);
-        };
-
+    // Combine eight corners into a 40-bit value: 5 bits per corner, the
+    // corner index and a bit for orientation 1 or 2, in the order UFR, UFL,
+    // UBR, UBL, DFR, DFL, DBR, DBL from the top bits down
+    uint64_t getCorners() const {
+        const uint8_t order[8] = {0, 1, 3, 2, 4, 5, 6, 7};
         uint64_t code = 0;
-        code |= getCornerStr(FACE::UP,    2, 2, FACE::FRONT, 0, 2, FACE::RIGHT, 0, 0) << 35;
-        code |= getCornerStr(FACE::UP,    2, 0, FACE::FRONT, 0, 0, FACE::LEFT,  0, 2) << 30;
-        code |= getCornerStr(FACE::UP,    0, 2, FACE::BACK,  0, 0, FACE::RIGHT, 0, 2) << 25;
-        code |= getCornerStr(FACE::UP,    0, 0, FACE::BACK,  0, 2, FACE::LEFT,  0, 0) << 20;
-        code |= getCornerStr(FACE::DOWN,  0, 2, FACE::FRONT, 2, 2, FACE::RIGHT, 2, 0) << 15;
-        code |= getCornerStr(FACE::DOWN,  0, 0, FACE::FRONT, 2, 0, FACE::LEFT,  2, 2) << 10;
-        code |= getCornerStr(FACE::DOWN,  2, 2, FACE::BACK,  2, 0, FACE::RIGHT, 2, 2) << 5;
-        code |= getCornerStr(FACE::DOWN,  2, 0, FACE::BACK,  2, 2, FACE::LEFT,  2, 0);
-
+        for (uint8_t ind : order) {
+            uint8_t ori = getCornerOrientation(ind);
+            code = code << 5 | getCornerIndex(ind) | (ori ? 4 << ori : 0);
+        }
         return code;
     }
 };
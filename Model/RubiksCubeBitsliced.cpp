@@ -0,0 +1,154 @@
+#include "RubiksCube.h"
+
+// Move networks of RubiksCubeBitsliced
+namespace bitsliced {
+    // Up to one stage per distinct sticker displacement
+    struct Network {
+        int count = 0;
+        uint64_t masks[48]{};
+        int rotations[48]{};
+    };
+
+    // For each face turned clockwise, the four rows of side stickers it
+    // cycles: each row receives the stickers of the next, the last the
+    // first's. Entries are {face, i, i, i}.
+    constexpr int sideCycles[6][4][4] = {
+        {{2, 0, 1, 2}, {3, 0, 1, 2}, {4, 0, 1, 2}, {1, 0, 1, 2}},   // U
+        {{2, 0, 7, 6}, {0, 0, 7, 6}, {4, 4, 3, 2}, {5, 0, 7, 6}},   // L
+        {{0, 4, 5, 6}, {1, 2, 3, 4}, {5, 0, 1, 2}, {3, 6, 7, 0}},   // F
+        {{0, 2, 3, 4}, {2, 2, 3, 4}, {5, 2, 3, 4}, {4, 6, 7, 0}},   // R
+        {{0, 0, 1, 2}, {3, 2, 3, 4}, {5, 4, 5, 6}, {1, 6, 7, 0}},   // B
+        {{2, 4, 5, 6}, {1, 4, 5, 6}, {4, 4, 5, 6}, {3, 4, 5, 6}},   // D
+    };
+
+    // Source sticker of each sticker after a clockwise turn of face
+    constexpr array<int, 48> getQuarterTurn(int face) {
+        array<int, 48> source{};
+        for (int s = 0; s < 48; s++) source[s] = s;
+        for (int i = 0; i < 8; i++) source[face * 8 + (i + 2) % 8] = face * 8 + i;
+        for (int row = 0; row < 4; row++) {
+            const int *to = sideCycles[face][row];
+            const int *from = sideCycles[face][(row + 1) % 4];
+            for (int j = 1; j < 4; j++) source[to[0] * 8 + to[j]] = from[0] * 8 + from[j];
+        }
+        return source;
+    }
+
+    // Group the stickers of a permutation by how far they move
+    constexpr Network getNetwork(const array<int, 48> &source) {
+        Network net;
+        for (int s = 0; s < 48; s++) {
+            int rotation = (s - source[s] + 64) % 64;
+            int stage = 0;
+            while (stage < net.count && net.rotations[stage] != rotation) stage++;
+            if (stage == net.count) net.rotations[net.count++] = rotation;
+            net.masks[stage] |= 1ull << source[s];
+        }
+        return net;
+    }
+
+    // Networks for every move, in MOVE order
+    constexpr array<Network, 18> networks = [] {
+        // Face of each MOVE group: L, R, U, D, F, B
+        constexpr int moveFaces[6] = {1, 3, 0, 5, 2, 4};
+        array<Network, 18> nets{};
+        for (int f = 0; f < 6; f++) {
+            array<int, 48> turn = getQuarterTurn(moveFaces[f]), source = turn;
+            for (int quarters = 1; quarters <= 3; quarters++) {
+                // quarters = 1, 3, 2 for the move, prime and double turn
+                int m = f * 3 + (quarters == 1 ? 0 : quarters == 3 ? 1 : 2);
+                nets[m] = getNetwork(source);
+                array<int, 48> next{};
+                for (int s = 0; s < 48; s++) next[s] = source[turn[s]];
+                source = next;
+            }
+        }
+        return nets;
+    }();
+}
+
+// Bitsliced representation of a Rubik’s Cube: the 48 non-center stickers
+// are bits 0..47 of three bitplanes, and bit k of a sticker's color is its
+// bit in plane k. Sticker face * 8 + i is the face's i-th sticker going
+// clockwise from the top-left corner, as in RubiksCubeBitboard. A move
+// sends every plane through the same fixed bit permutation, computed once
+// from the face cycles as a network of masked rotates: stickers that move
+// the same distance share one mask.
+class RubiksCubeBitsliced : public RubiksCube {
+private:
+    static constexpr array<uint64_t, 3> solvedPlanes = [] {
+        array<uint64_t, 3> planes{};
+        for (int face = 0; face < 6; face++)
+            for (int k = 0; k < 3; k++)
+                if (face >> k & 1) planes[k] |= 0xFFull << (8 * face);
+        return planes;
+    }();
+
+    static constexpr int arr[3][3] = {{0, 1, 2},
+                                      {7, 8, 3},
+                                      {6, 5, 4}};
+
+    template<int M>
+    RubiksCube& apply() {
+        constexpr const bitsliced::Network &net = bitsliced::networks[M];
+        uint64_t moved0 = 0, moved1 = 0, moved2 = 0;
+#pragma GCC unroll 48
+        for (int stage = 0; stage < net.count; stage++) {
+            moved0 |= rotl(planes[0] & net.masks[stage], net.rotations[stage]);
+            moved1 |= rotl(planes[1] & net.masks[stage], net.rotations[stage]);
+            moved2 |= rotl(planes[2] & net.masks[stage], net.rotations[stage]);
+        }
+        planes = {moved0, moved1, moved2};
+        return *this;
+    }
+
+public:
+    array<uint64_t, 3> planes = solvedPlanes;
+
+    // Return the color at (face, row, col)
+    COLOR getColor(FACE face, unsigned row, unsigned col) const override {
+        int idx = arr[row][col];
+        if (idx == 8) return (COLOR)face;
+        int s = (int)face * 8 + idx;
+        int color = 0;
+        for (int k = 0; k < 3; k++) color |= (int)((planes[k] >> s) & 1) << k;
+        return (COLOR)color;
+    }
+
+    bool isSolved() const override {
+        return planes == solvedPlanes;
+    }
+
+    RubiksCube& l() override { return apply<(int)MOVE::L>(); }
+    RubiksCube& lPrime() override { return apply<(int)MOVE::LPRIME>(); }
+    RubiksCube& l2() override { return apply<(int)MOVE::L2>(); }
+    RubiksCube& r() override { return apply<(int)MOVE::R>(); }
+    RubiksCube& rPrime() override { return apply<(int)MOVE::RPRIME>(); }
+    RubiksCube& r2() override { return apply<(int)MOVE::R2>(); }
+    RubiksCube& u() override { return apply<(int)MOVE::U>(); }
+    RubiksCube& uPrime() override { return apply<(int)MOVE::UPRIME>(); }
+    RubiksCube& u2() override { return apply<(int)MOVE::U2>(); }
+    RubiksCube& d() override { return apply<(int)MOVE::D>(); }
+    RubiksCube& dPrime() override { return apply<(int)MOVE::DPRIME>(); }
+    RubiksCube& d2() override { return apply<(int)MOVE::D2>(); }
+    RubiksCube& f() override { return apply<(int)MOVE::F>(); }
+    RubiksCube& fPrime() override { return apply<(int)MOVE::FPRIME>(); }
+    RubiksCube& f2() override { return apply<(int)MOVE::F2>(); }
+    RubiksCube& b() override { return apply<(int)MOVE::B>(); }
+    RubiksCube& bPrime() override { return apply<(int)MOVE::BPRIME>(); }
+    RubiksCube& b2() override { return apply<(int)MOVE::B2>(); }
+
+    bool operator==(const RubiksCubeBitsliced &other) const {
+        return planes == other.planes;
+    }
+};
+
+// Hash functor for bitsliced cubes
+struct HashBitsliced {
+    size_t operator()(const RubiksCubeBitsliced &c) const {
+        uint64_t h = c.planes[0] * 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 29) ^ c.planes[1]) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 32) ^ c.planes[2]) * 0x94D049BB133111EBull;
+        return (size_t)(h ^ (h >> 31));
+    }
+};
@@ -0,0 +1,275 @@
+#include "BlockCompressedFile.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'R', 'C', 'P', 'D', 'B', 'Z', '1', '\n'};
+    const size_t HEADER_BYTES = 8 + 8 + 4 + 4;
+    const size_t LENGTHS_BYTES = 128;       // 256 code lengths as nibbles
+
+    // Longest code; the decoder looks codes up in a table of 1 << this
+    const int MAX_CODE_LENGTH = 12;
+
+    // Huffman code lengths for byte counts, at most MAX_CODE_LENGTH long:
+    // while the tree is too deep, halve the counts and build it again
+    array<uint8_t, 256> getCodeLengths(array<uint64_t, 256> counts) {
+        while (true) {
+            typedef pair<uint64_t, int> Node;           // weight, id
+            priority_queue<Node, vector<Node>, greater<Node>> heap;
+            for (int s = 0; s < 256; s++)
+                if (counts[s]) heap.push({counts[s], s});
+
+            array<uint8_t, 256> lengths{};
+            if (heap.size() == 1) {
+                lengths[heap.top().second] = 1;
+                return lengths;
+            }
+            // Leaves are 0..255, merged nodes 256 on
+            vector<int> parent(512, -1);
+            for (int next = 256; heap.size() > 1; next++) {
+                Node a = heap.top(); heap.pop();
+                Node b = heap.top(); heap.pop();
+                parent[a.second] = parent[b.second] = next;
+                heap.push({a.first + b.first, next});
+            }
+
+            int longest = 0;
+            for (int s = 0; s < 256; s++) {
+                if (!counts[s]) continue;
+                int depth = 0;
+                for (int node = s; parent[node] >= 0; node = parent[node]) depth++;
+                lengths[s] = depth;
+                longest = max(longest, depth);
+            }
+            if (longest <= MAX_CODE_LENGTH) return lengths;
+            for (auto &count : counts)
+                if (count) count = (count + 1) / 2;
+        }
+    }
+
+    // Canonical codes: shorter codes first, then by byte value. Throws if
+    // the lengths don't form a prefix code of codes up to MAX_CODE_LENGTH.
+    array<uint16_t, 256> getCodes(const array<uint8_t, 256> &lengths) {
+        for (uint8_t len : lengths)
+            if (len > MAX_CODE_LENGTH) throw "Compressed database corrupt";
+        array<uint16_t, 256> codes{};
+        uint32_t code = 0;
+        for (int len = 1; len <= MAX_CODE_LENGTH; len++) {
+            for (int s = 0; s < 256; s++) {
+                if (lengths[s] != len) continue;
+                if (code >= (1u << len)) throw "Compressed database corrupt";
+                codes[s] = code++;
+            }
+            code <<= 1;
+        }
+        return codes;
+    }
+
+    vector<uint8_t> compressBlock(const uint8_t *data, size_t size) {
+        array<uint64_t, 256> counts{};
+        for (size_t i = 0; i < size; i++) counts[data[i]]++;
+        array<uint8_t, 256> lengths = getCodeLengths(counts);
+        array<uint16_t, 256> codes = getCodes(lengths);
+
+        vector<uint8_t> out(LENGTHS_BYTES);
+        for (int s = 0; s < 256; s += 2) out[s / 2] = lengths[s] << 4 | lengths[s + 1];
+        out.reserve(LENGTHS_BYTES + size);
+
+        uint64_t bits = 0;          // pending bits, the last count of them
+        int count = 0;
+        for (size_t i = 0; i < size; i++) {
+            bits = bits << lengths[data[i]] | codes[data[i]];
+            count += lengths[data[i]];
+            while (count >= 8) {
+                count -= 8;
+                out.push_back((uint8_t) (bits >> count));
+            }
+        }
+        if (count > 0) out.push_back((uint8_t) (bits << (8 - count)));
+        return out;
+    }
+
+    // Decode size bytes from a block of n compressed bytes into dest. The
+    // block must be followed by 8 readable bytes.
+    void decompressBlock(const uint8_t *in, size_t n, uint8_t *dest, size_t size) {
+        if (n < LENGTHS_BYTES) throw "Compressed database corrupt";
+        array<uint8_t, 256> lengths;
+        for (int s = 0; s < 256; s += 2) {
+            lengths[s] = in[s / 2] >> 4;
+            lengths[s + 1] = in[s / 2] & 0x0F;
+            if (lengths[s] > MAX_CODE_LENGTH || lengths[s + 1] > MAX_CODE_LENGTH)
+                throw "Compressed database corrupt";
+        }
+        array<uint16_t, 256> codes = getCodes(lengths);
+
+        // The code starting each MAX_CODE_LENGTH-bit prefix: its byte in
+        // the low byte, its length in the high byte (0 if none starts so)
+        const int TABLE_SIZE = 1 << MAX_CODE_LENGTH;
+        vector<uint16_t> single(TABLE_SIZE, 0);
+        for (int s = 0; s < 256; s++) {
+            if (!lengths[s]) continue;
+            int spare = MAX_CODE_LENGTH - lengths[s];
+            uint32_t first = (uint32_t) codes[s] << spare;
+            fill(single.begin() + first, single.begin() + first + (1u << spare), (uint16_t) (lengths[s] << 8 | s));
+        }
+        // Both codes if the prefix holds two whole ones, else the first:
+        // bytes in bits 0..15, total length in 16..23, bit 24 set for two
+        vector<uint32_t> table(TABLE_SIZE);
+        for (uint32_t prefix = 0; prefix < TABLE_SIZE; prefix++) {
+            uint32_t first = single[prefix], len = first >> 8;
+            table[prefix] = len << 16 | (first & 0xFF);
+            if (!len) continue;
+            uint32_t second = single[(prefix << len) & (TABLE_SIZE - 1)];
+            if ((second >> 8) && len + (second >> 8) <= MAX_CODE_LENGTH)
+                table[prefix] = 1u << 24 | (len + (second >> 8)) << 16 | (second & 0xFF) << 8 | (first & 0xFF);
+        }
+
+        in += LENGTHS_BYTES;
+        n -= LENGTHS_BYTES;
+        uint64_t bits = 0;          // next bits, from the most significant
+        int count = 0;              // how many of them are valid
+        size_t pos = 0;             // next byte not in bits
+        size_t i = 0;
+        while (i < size) {
+            if (count < MAX_CODE_LENGTH) {
+                // Top up to at least 56 bits with one unaligned load; bits
+                // loaded past count are loaded again next time
+                uint64_t word;
+                memcpy(&word, in + min(pos, n), 8);
+                bits |= __builtin_bswap64(word) >> count;
+                pos += (63 - count) >> 3;
+                count |= 56;
+            }
+            uint32_t entry = table[bits >> (64 - MAX_CODE_LENGTH)];
+            int len = entry >> 16 & 0xFF;
+            if (!len) throw "Compressed database corrupt";
+            dest[i++] = (uint8_t) entry;
+            if (entry >> 24) {
+                // The second byte; past the end it is only padding bits
+                if (i == size) break;
+                dest[i++] = (uint8_t) (entry >> 8);
+            }
+            bits <<= len;
+            count -= len;
+        }
+        if (pos * 8 - count > n * 8) throw "Compressed database corrupt";
+    }
+
+    // Run work(block) for every block, spread over threads. The first
+    // error thrown by any block is thrown again once all have stopped.
+    void forEachBlock(size_t numBlocks, unsigned threads, const function<void(size_t)> &work) {
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        threads = (unsigned) min<size_t>(threads, max<size_t>(numBlocks, 1));
+
+        atomic<size_t> nextBlock{0};
+        atomic<const char*> error{nullptr};
+        auto worker = [&] {
+            for (size_t b; !error.load() && (b = nextBlock.fetch_add(1)) < numBlocks; ) {
+                try {
+                    work(b);
+                } catch (const char *e) {
+                    const char *none = nullptr;
+                    error.compare_exchange_strong(none, e);
+                }
+            }
+        };
+        vector<thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+        worker();
+        for (auto &t : pool) t.join();
+        if (error.load()) throw error.load();
+    }
+
+    bool readAt(int fd, void *buf, size_t n, off_t offset) {
+        for (size_t done = 0; done < n; ) {
+            ssize_t got = pread(fd, static_cast<uint8_t*>(buf) + done, n - done, offset + done);
+            if (got <= 0) return false;
+            done += got;
+        }
+        return true;
+    }
+}
+
+bool BlockCompressedFile::isCompressed(const string &filePath) {
+    ifstream reader(filePath, ios::in | ios::binary);
+    char magic[8];
+    return reader.read(magic, 8) && memcmp(magic, MAGIC, 8) == 0;
+}
+
+void BlockCompressedFile::write(const string &filePath, const uint8_t *data, size_t size,
+                                size_t blockBytes, unsigned threads) {
+    uint32_t numBlocks = (uint32_t) ((size + blockBytes - 1) / blockBytes);
+    vector<vector<uint8_t>> blocks(numBlocks);
+    forEachBlock(numBlocks, threads, [&](size_t b) {
+        size_t begin = b * blockBytes;
+        blocks[b] = compressBlock(data + begin, min(blockBytes, size - begin));
+    });
+
+    ofstream writer(filePath, ios::out | ios::binary | ios::trunc);
+    if (!writer.is_open())
+        throw "Failed to open file for writing";
+
+    uint64_t rawSize = size;
+    uint32_t blockSize = (uint32_t) blockBytes;
+    writer.write(MAGIC, 8);
+    writer.write(reinterpret_cast<const char*>(&rawSize), 8);
+    writer.write(reinterpret_cast<const char*>(&blockSize), 4);
+    writer.write(reinterpret_cast<const char*>(&numBlocks), 4);
+    uint64_t offset = 0;
+    for (uint32_t b = 0; b <= numBlocks; b++) {
+        writer.write(reinterpret_cast<const char*>(&offset), 8);
+        if (b < numBlocks) offset += blocks[b].size();
+    }
+    for (auto &block : blocks)
+        writer.write(reinterpret_cast<const char*>(block.data()), block.size());
+    writer.close();
+}
+
+bool BlockCompressedFile::read(const string &filePath, uint8_t *dest, size_t size, unsigned threads) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    char magic[8];
+    uint64_t rawSize = 0;
+    uint32_t blockBytes = 0, numBlocks = 0;
+    bool ok = readAt(fd, magic, 8, 0) && readAt(fd, &rawSize, 8, 8) &&
+              readAt(fd, &blockBytes, 4, 16) && readAt(fd, &numBlocks, 4, 20) &&
+              memcmp(magic, MAGIC, 8) == 0 && rawSize == size;
+    if (!ok) {
+        close(fd);
+        throw "Database corrupt or size mismatch";
+    }
+
+    // The offsets must cover the rest of the file in order
+    vector<uint64_t> offsets(numBlocks + 1);
+    size_t dataStart = HEADER_BYTES + offsets.size() * 8;
+    struct stat st;
+    ok = blockBytes > 0 && numBlocks == (size + blockBytes - 1) / blockBytes &&
+         readAt(fd, offsets.data(), offsets.size() * 8, HEADER_BYTES) &&
+         fstat(fd, &st) == 0 && offsets[0] == 0 &&
+         dataStart + offsets[numBlocks] == (uint64_t) st.st_size;
+    for (uint32_t b = 0; ok && b < numBlocks; b++) ok = offsets[b] <= offsets[b + 1];
+    if (!ok) {
+        close(fd);
+        throw "Compressed database corrupt";
+    }
+
+    try {
+        forEachBlock(numBlocks, threads, [&](size_t b) {
+            // With the zeroed tail decompressBlock() reads ahead into
+            thread_local vector<uint8_t> in;
+            size_t n = offsets[b + 1] - offsets[b];
+            in.assign(n + 8, 0);
+            if (!readAt(fd, in.data(), n, dataStart + offsets[b]))
+                throw "Compressed database corrupt";
+            size_t begin = b * blockBytes;
+            decompressBlock(in.data(), n, dest + begin, min<size_t>(blockBytes, size - begin));
+        });
+    } catch (const char *) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return true;
+}
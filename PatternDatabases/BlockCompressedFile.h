@@ -0,0 +1,38 @@
+#ifndef RUBIKS_CUBE_SOLVER_BLOCKCOMPRESSEDFILE_H
+#define RUBIKS_CUBE_SOLVER_BLOCKCOMPRESSEDFILE_H
+
+#include <bits/stdc++.h>
+using namespace std;
+
+// On-disk container for pattern database bytes, cut into independent
+// blocks that are compressed and decompressed in parallel. Database
+// entries pile up on a few depths, so each block gets its own canonical
+// Huffman code over its bytes (nibble pairs), which takes the corner
+// database to about 40% of its raw size.
+//
+// Layout, in host byte order:
+//   magic "RCPDBZ1\n", raw size (uint64), block size (uint32),
+//   block count (uint32), block offsets from the end of the header
+//   (uint64 each, plus one past the last block), then the blocks.
+// A block is its 256 code lengths as nibbles, then the coded bits, most
+// significant bit first.
+class BlockCompressedFile {
+public:
+    static const size_t DEFAULT_BLOCK_BYTES = 1 << 20;
+
+    // Whether the file starts with the container's magic
+    static bool isCompressed(const string &filePath);
+
+    // Compress size bytes of data into filePath, a block per thread at a
+    // time (0 threads: one per CPU). Throws if the file can't be written.
+    static void write(const string &filePath, const uint8_t *data, size_t size,
+                      size_t blockBytes = DEFAULT_BLOCK_BYTES, unsigned threads = 0);
+
+    // Decompress filePath into size bytes at dest. Each thread reads and
+    // decodes its own blocks, so reading overlaps decoding. Returns false
+    // if the file can't be opened; throws if it is corrupt or holds a
+    // different size.
+    static bool read(const string &filePath, uint8_t *dest, size_t size, unsigned threads = 0);
+};
+
+#endif // RUBIKS_CUBE_SOLVER_BLOCKCOMPRESSEDFILE_H
@@ -0,0 +1,146 @@
+#include "CornerCosetEnumerator.h"
+
+namespace {
+    const char CHECKPOINT_MAGIC[8] = {'C', 'O', 'S', 'E', 'T', 'S', '0', '1'};
+}
+
+CornerCosetEnumerator::CornerCosetEnumerator(const string &checkpointFile)
+    : tables(CornerMoveTables::getInstance()), checkpointPath(checkpointFile), depth(0),
+      seen((size_t) NUM_COSETS * WORDS, 0), frontier((size_t) NUM_COSETS * WORDS, 0),
+      next((size_t) NUM_COSETS * WORDS, 0) {
+    if (!checkpointPath.empty() && loadCheckpoint()) return;
+
+    CornerCoordinate solved = tables.getCoordinate(CornerCubies());
+    size_t word = (size_t) solved.orientation * WORDS + solved.perm / 64;
+    seen[word] = frontier[word] = 1ull << (solved.perm % 64);
+    counts.assign(1, vector<uint32_t>(NUM_COSETS, 0));
+    counts[0][solved.orientation] = 1;
+}
+
+uint32_t CornerCosetEnumerator::expandCoset(int coset, bool backward) {
+    uint64_t *out = &next[(size_t) coset * WORDS];
+    fill(out, out + WORDS, 0);
+    uint64_t *known = &seen[(size_t) coset * WORDS];
+
+    // Near the end few states are left: test each unseen one for a
+    // neighbour in the frontier instead of expanding the whole frontier
+    if (backward) {
+        uint32_t found = 0;
+        for (int w = 0; w < WORDS; w++) {
+            uint64_t unseen = ~known[w];
+            if (w == WORDS - 1 && COSET_SIZE % 64) unseen &= (1ull << (COSET_SIZE % 64)) - 1;
+            for (; unseen; unseen &= unseen - 1) {
+                uint16_t perm = w * 64 + __builtin_ctzll(unseen);
+                for (int i = 0; i < 18; i++) {
+                    CornerCoordinate n = tables.move({perm, (uint16_t) coset}, RubiksCube::MOVE(i));
+                    if (frontier[(size_t) n.orientation * WORDS + n.perm / 64] >> (n.perm % 64) & 1) {
+                        out[w] |= unseen & -unseen;
+                        found++;
+                        break;
+                    }
+                }
+            }
+            known[w] |= out[w];
+        }
+        return found;
+    }
+
+    // A state reached by m comes from the coset that m maps onto this one.
+    // For the ten H moves that is the coset itself.
+    for (int i = 0; i < 18; i++) {
+        RubiksCube::MOVE m = RubiksCube::MOVE(i);
+        uint16_t from = tables.move({0, (uint16_t) coset}, RubiksCube::getInverseMove(m)).orientation;
+        const uint64_t *in = &frontier[(size_t) from * WORDS];
+        for (int w = 0; w < WORDS; w++) {
+            for (uint64_t bits = in[w]; bits; bits &= bits - 1) {
+                uint16_t perm = w * 64 + __builtin_ctzll(bits);
+                uint16_t to = tables.move({perm, from}, m).perm;
+                out[to / 64] |= 1ull << (to % 64);
+            }
+        }
+    }
+
+    uint32_t found = 0;
+    for (int w = 0; w < WORDS; w++) {
+        out[w] &= ~known[w];
+        known[w] |= out[w];
+        found += __builtin_popcountll(out[w]);
+    }
+    return found;
+}
+
+bool CornerCosetEnumerator::step(int numThreads) {
+    // Forward costs 18 probes per frontier state, backward up to 18 per
+    // unseen state
+    auto distribution = getDistribution();
+    uint64_t reached = accumulate(distribution.begin(), distribution.end(), 0ull);
+    bool backward = (uint64_t) NUM_COSETS * COSET_SIZE - reached < distribution.back();
+
+    vector<uint32_t> found(NUM_COSETS, 0);
+    atomic<int> nextCoset{0};
+    auto work = [&] {
+        for (int c; (c = nextCoset.fetch_add(1)) < NUM_COSETS;) found[c] = expandCoset(c, backward);
+    };
+    vector<thread> threads;
+    for (int t = 1; t < numThreads; t++) threads.emplace_back(work);
+    work();
+    for (auto &t : threads) t.join();
+
+    if (accumulate(found.begin(), found.end(), 0ull) == 0) return false;
+    frontier.swap(next);
+    counts.push_back(std::move(found));
+    depth++;
+    if (!checkpointPath.empty() && !saveCheckpoint()) {
+        throw "Cannot write coset checkpoint";
+    }
+    return true;
+}
+
+void CornerCosetEnumerator::run(int numThreads, const function<void(int)> &onDepth) {
+    while (step(numThreads)) {
+        if (onDepth) onDepth(depth);
+    }
+}
+
+vector<uint64_t> CornerCosetEnumerator::getDistribution() const {
+    vector<uint64_t> total;
+    for (auto &row : counts) total.push_back(accumulate(row.begin(), row.end(), 0ull));
+    return total;
+}
+
+// Written to a temporary file and renamed, so a crash mid-write keeps the
+// previous checkpoint
+bool CornerCosetEnumerator::saveCheckpoint() const {
+    string tmpPath = checkpointPath + ".tmp";
+    ofstream out(tmpPath, ios::binary | ios::trunc);
+    if (!out) return false;
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+    for (auto &row : counts) {
+        out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(uint32_t));
+    }
+    out.write(reinterpret_cast<const char*>(seen.data()), seen.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(frontier.data()), frontier.size() * sizeof(uint64_t));
+    out.close();
+    if (!out) return false;
+    return rename(tmpPath.c_str(), checkpointPath.c_str()) == 0;
+}
+
+bool CornerCosetEnumerator::loadCheckpoint() {
+    ifstream in(checkpointPath, ios::binary);
+    if (!in) return false;
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&depth), sizeof(depth));
+    if (!in || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || depth < 0 || depth > 64) {
+        throw "Coset checkpoint corrupt";
+    }
+    counts.assign(depth + 1, vector<uint32_t>(NUM_COSETS));
+    for (auto &row : counts) {
+        in.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(uint32_t));
+    }
+    in.read(reinterpret_cast<char*>(seen.data()), seen.size() * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(frontier.data()), frontier.size() * sizeof(uint64_t));
+    if (!in || in.peek() != EOF) throw "Coset checkpoint corrupt";
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef RUBIKS_CUBE_SOLVER_CORNERCOSETENUMERATOR_H
+#define RUBIKS_CUBE_SOLVER_CORNERCOSETENUMERATOR_H
+
+#include "../Model/RubiksCube.h"
+#include "CornerMoveTables.h"
+using namespace std;
+
+// Exact distance distribution of all 8! * 3^7 corner states, swept one
+// depth at a time through the cosets of H = <U, D, L2, R2, F2, B2>. H never
+// twists a corner, so each coset is one orientation coordinate holding all
+// 40320 permutations, kept as a bitmap. A depth is built coset by coset:
+// H moves permute bits within the coset, the other eight pull in the
+// previous frontier of neighbouring cosets. Once fewer states remain
+// unseen than the frontier holds, the sweep runs backward from them.
+// Cosets are independent within a depth, so they are spread over threads,
+// and the bitmaps are saved after every depth so an interrupted run
+// resumes where it stopped.
+class CornerCosetEnumerator {
+public:
+    static const int NUM_COSETS = CornerMoveTables::NUM_ORIENTATIONS;
+    static const int COSET_SIZE = CornerMoveTables::NUM_PERMS;
+
+private:
+    static const int WORDS = (COSET_SIZE + 63) / 64;   // bitmap words per coset
+
+    const CornerMoveTables &tables;
+    string checkpointPath;
+    int depth;                              // deepest finished depth
+    vector<uint64_t> seen;                  // [coset * WORDS + word]
+    vector<uint64_t> frontier;              // states at exactly depth
+    vector<uint64_t> next;
+    vector<vector<uint32_t>> counts;        // [depth][coset]
+
+    // Fill next for one coset from frontier, expanding the frontier or
+    // checking unseen states backward; returns its new state count
+    uint32_t expandCoset(int coset, bool backward);
+
+    bool saveCheckpoint() const;
+    bool loadCheckpoint();
+
+public:
+    // Resumes from checkpointFile if it exists; an empty name disables
+    // checkpoints
+    explicit CornerCosetEnumerator(const string &checkpointFile = "");
+
+    int getDepth() const { return depth; }
+
+    // Sweep the next depth; returns false once it found no new states
+    bool step(int numThreads);
+
+    // Step until the whole group is enumerated
+    void run(int numThreads, const function<void(int depth)> &onDepth = nullptr);
+
+    // States of coset at exactly depth d
+    uint32_t getCount(int coset, int d) const { return counts[d][coset]; }
+
+    // States at exactly each depth, over all cosets
+    vector<uint64_t> getDistribution() const;
+};
+
+#endif // RUBIKS_CUBE_SOLVER_CORNERCOSETENUMERATOR_H
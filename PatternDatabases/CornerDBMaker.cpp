@@ -11,31 +11,37 @@ CornerDBMaker::CornerDBMaker(string _fileName, uint8_t init_val) {
     cornerDB = CornerPatternDatabase(init_val);
 }
 
-bool CornerDBMaker::bfsAndStore() {
-    RubiksCubeBitboard cube;
-    queue<RubiksCubeBitboard> q;
-    q.push(cube);
-    cornerDB.setNumMoves(cube, 0);
-    int curr_depth = 0;
-    while (!q.empty()) {
-        int n = q.size();
-        curr_depth++;
-        if (curr_depth == 9) break;
-        for (int counter = 0; counter < n; counter++) {
-            RubiksCubeBitboard node = q.front();
-            q.pop();
+// Breadth-first from solved, a batch of frontier cubes at a time: every
+// move is applied to the whole batch and its corner indices read at once.
+bool CornerDBMaker::bfsAndStore(int maxDepth) {
+    const int LANES = CubeBatch::LANES;
+    CubeBatch batch;
+    uint32_t indices[LANES];
+    batch.getCornerIndices(indices);
+    cornerDB.setNumMoves(indices[0], 0);
+
+    vector<CubieCube> frontier(1), next;
+    for (int curr_depth = 1; curr_depth <= maxDepth && !frontier.empty(); curr_depth++) {
+        next.clear();
+        for (size_t start = 0; start < frontier.size(); start += LANES) {
+            int n = (int) min<size_t>(LANES, frontier.size() - start);
+            for (int lane = 0; lane < n; lane++) batch.set(lane, frontier[start + lane]);
             for (int i = 0; i < 18; i++) {
                 auto curr_move = RubiksCube::MOVE(i);
-                node.move(curr_move);
-                if ((int) cornerDB.getNumMoves(node) > curr_depth) {
-                    cornerDB.setNumMoves(node, curr_depth);
-                    q.push(node);
+                batch.apply(curr_move);
+                batch.getCornerIndices(indices);
+                for (int lane = 0; lane < n; lane++) {
+                    if ((int) cornerDB.getNumMoves(indices[lane]) > curr_depth) {
+                        cornerDB.setNumMoves(indices[lane], curr_depth);
+                        next.push_back(batch.get(lane));
+                    }
                 }
-                node.invert(curr_move);
+                batch.apply(RubiksCube::getInverseMove(curr_move));
             }
         }
+        swap(frontier, next);
     }
 
     cornerDB.toFile(fileName);
     return true;
-}
\ No newline at end of file
+}
@@ -1,7 +1,7 @@
 #ifndef RUBIKS_CUBE_SOLVER_CORNERDBMAKER_H
 #define RUBIKS_CUBE_SOLVER_CORNERDBMAKER_H
 #include "CornerPatternDatabase.h"
-#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/CubeBatch.h"
 
 using namespace std;
 
@@ -14,7 +14,9 @@ public:
     CornerDBMaker(string _fileName);
     CornerDBMaker(string _fileName, uint8_t init_val);
 
-    bool bfsAndStore();
+    // Store every state up to maxDepth moves from solved; deeper ones keep
+    // the initial value. 11 fills the whole table.
+    bool bfsAndStore(int maxDepth = 8);
 };
 
 
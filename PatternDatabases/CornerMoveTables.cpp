@@ -0,0 +1,79 @@
+#include "CornerMoveTables.h"
+
+namespace {
+    uint16_t getPermCoordinate(const CornerCubies &corners) {
+        array<uint8_t, 8> codes;
+        for (uint8_t i = 0; i < 8; i++) codes[i] = corners.getCornerIndex(i);
+        return PermutationIndexer<8>::rank(codes);
+    }
+
+    // Rebuild a corner state with the given permutation coordinate and
+    // no twist
+    CornerCubies getPermState(uint16_t perm) {
+        CornerCubies corners;
+        array<uint8_t, 8> codes = PermutationIndexer<8>::unrank(perm);
+        for (uint8_t i = 0; i < 8; i++) corners.setCornerIndex(i, codes[i]);
+        return corners;
+    }
+
+    uint16_t getOrientationCoordinate(const CornerCubies &corners) {
+        uint16_t ori = 0;
+        for (uint8_t i = 0; i < 7; i++) ori = ori * 3 + corners.getCornerOrientation(i);
+        return ori;
+    }
+
+    // Rebuild a corner state with the given orientation coordinate and
+    // solved permutation; the last twist follows from the other seven.
+    CornerCubies getOrientationState(uint16_t ori) {
+        CornerCubies corners;
+        int sum = 0;
+        for (int i = 6; i >= 0; i--) {
+            // The sticker-order conversion is its own inverse
+            corners.co[i] = ori % 3;
+            corners.co[i] = corners.getCornerOrientation(i);
+            sum += corners.co[i];
+            ori /= 3;
+        }
+        corners.co[7] = (3 - sum % 3) % 3;
+        return corners;
+    }
+}
+
+CornerMoveTables::CornerMoveTables()
+    : permMoves(NUM_PERMS * 18), orientationMoves(NUM_ORIENTATIONS * 18) {
+    buildPermTable();
+    buildOrientationTable();
+}
+
+const CornerMoveTables& CornerMoveTables::getInstance() {
+    static const CornerMoveTables tables;
+    return tables;
+}
+
+void CornerMoveTables::buildPermTable() {
+    for (uint16_t perm = 0; perm < NUM_PERMS; perm++) {
+        CornerCubies node = getPermState(perm);
+        for (int m = 0; m < 18; m++) {
+            CornerCubies next = CornerCubies::multiply(node, CornerCubies::getMove(RubiksCube::MOVE(m)));
+            permMoves[perm * 18 + m] = getPermCoordinate(next);
+        }
+    }
+}
+
+void CornerMoveTables::buildOrientationTable() {
+    for (uint16_t ori = 0; ori < NUM_ORIENTATIONS; ori++) {
+        CornerCubies node = getOrientationState(ori);
+        for (int m = 0; m < 18; m++) {
+            CornerCubies next = CornerCubies::multiply(node, CornerCubies::getMove(RubiksCube::MOVE(m)));
+            orientationMoves[ori * 18 + m] = getOrientationCoordinate(next);
+        }
+    }
+}
+
+CornerCoordinate CornerMoveTables::getCoordinate(const CornerCubies &corners) const {
+    return {getPermCoordinate(corners), getOrientationCoordinate(corners)};
+}
+
+CornerCoordinate CornerMoveTables::getCoordinate(const RubiksCube &cube) const {
+    return getCoordinate(CornerCubies::fromCube(cube));
+}
@@ -0,0 +1,50 @@
+#ifndef RUBIKS_CUBE_SOLVER_CORNERMOVETABLES_H
+#define RUBIKS_CUBE_SOLVER_CORNERMOVETABLES_H
+
+#include "../Model/RubiksCube.h"
+#include "../Model/CubieCube.h"
+#include "PermutationIndexer.h"
+using namespace std;
+
+// The two halves of a CornerPatternDatabase index:
+// index = perm * 2187 + orientation.
+struct CornerCoordinate {
+    uint16_t perm;          // rank of the corner permutation, 0..40319
+    uint16_t orientation;   // base-3 twists of corners 0..6, 0..2186
+
+    uint32_t getDatabaseIndex() const {
+        return (uint32_t) perm * 2187 + orientation;
+    }
+};
+
+// Move tables over the corner coordinates, so a search can carry the
+// coordinate of its current node and update it per move with two lookups
+// instead of re-reading and re-ranking all eight corners.
+class CornerMoveTables {
+    vector<uint16_t> permMoves;         // [perm * 18 + move]
+    vector<uint16_t> orientationMoves;  // [orientation * 18 + move]
+
+    CornerMoveTables();
+
+    void buildPermTable();
+    void buildOrientationTable();
+
+public:
+    static const int NUM_PERMS = 40320;
+    static const int NUM_ORIENTATIONS = 2187;
+
+    // Tables are built once on first use and shared
+    static const CornerMoveTables& getInstance();
+
+    CornerCoordinate getCoordinate(const CornerCubies &corners) const;
+    CornerCoordinate getCoordinate(const RubiksCube &cube) const;
+
+    // Coordinate after applying move
+    CornerCoordinate move(CornerCoordinate coord, RubiksCube::MOVE move) const {
+        int m = (int) move;
+        return {permMoves[coord.perm * 18 + m],
+                orientationMoves[coord.orientation * 18 + m]};
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_CORNERMOVETABLES_H
@@ -1,5 +1,51 @@
 #include "CornerPatternDatabase.h"
 
+namespace {
+    // Distances from solved of each value of one coordinate, moving it
+    // alone through the move tables: lower bounds on the whole cube's
+    template<typename Next>
+    vector<uint8_t> getCoordinateDistances(int count, uint16_t solved, Next next) {
+        vector<uint8_t> distances(count, 0xFF);
+        vector<uint16_t> frontier = {solved};
+        distances[solved] = 0;
+        for (uint8_t depth = 1; !frontier.empty(); depth++) {
+            vector<uint16_t> reached;
+            for (uint16_t value : frontier) {
+                for (int m = 0; m < 18; m++) {
+                    uint16_t to = next(value, RubiksCube::MOVE(m));
+                    if (distances[to] != 0xFF) continue;
+                    distances[to] = depth;
+                    reached.push_back(to);
+                }
+            }
+            frontier.swap(reached);
+        }
+        return distances;
+    }
+
+    const vector<uint8_t>& getPermDistances() {
+        static const vector<uint8_t> distances = [] {
+            const CornerMoveTables &tables = CornerMoveTables::getInstance();
+            uint16_t solved = tables.getCoordinate(CornerCubies()).perm;
+            return getCoordinateDistances(CornerMoveTables::NUM_PERMS, solved, [&](uint16_t perm, RubiksCube::MOVE m) {
+                return tables.move({perm, 0}, m).perm;
+            });
+        }();
+        return distances;
+    }
+
+    const vector<uint8_t>& getOrientationDistances() {
+        static const vector<uint8_t> distances = [] {
+            const CornerMoveTables &tables = CornerMoveTables::getInstance();
+            uint16_t solved = tables.getCoordinate(CornerCubies()).orientation;
+            return getCoordinateDistances(CornerMoveTables::NUM_ORIENTATIONS, solved, [&](uint16_t ori, RubiksCube::MOVE m) {
+                return tables.move({0, ori}, m).orientation;
+            });
+        }();
+        return distances;
+    }
+}
+
 CornerPatternDatabase::CornerPatternDatabase() : PatternDatabase(100179840) {}
 
 CornerPatternDatabase::CornerPatternDatabase(uint8_t init_val) : PatternDatabase(100179840, init_val) {}
@@ -17,7 +63,7 @@ uint32_t CornerPatternDatabase::getDatabaseIndex(const RubiksCube &cube) const {
             cube.getCornerIndex(7),
             };
 
-    uint32_t rank = this->permIndexer.rank(cornerPerm);
+    uint32_t rank = PermutationIndexer<8>::rank(cornerPerm);
 
     array<uint8_t, 7> cornerOrientations = {
             cube.getCornerOrientation(0),
@@ -39,4 +85,10 @@ uint32_t CornerPatternDatabase::getDatabaseIndex(const RubiksCube &cube) const {
             cornerOrientations[6];
 
     return (rank * 2187) + orientationNum;
-}
\ No newline at end of file
+}
+
+uint8_t CornerPatternDatabase::getFallback(const uint32_t index) const {
+    // The database is larger than the 40320 * 2187 indices in use
+    if (index / 2187 >= CornerMoveTables::NUM_PERMS) return 0;
+    return max(getPermDistances()[index / 2187], getOrientationDistances()[index % 2187]);
+}
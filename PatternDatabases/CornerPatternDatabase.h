@@ -4,19 +4,27 @@
 #include "../Model/RubiksCube.h"
 #include "PatternDatabase.h"
 #include "PermutationIndexer.h"
+#include "CornerMoveTables.h"
 using namespace std;
 
 class CornerPatternDatabase : public PatternDatabase {
 
     typedef RubiksCube::FACE F;
 
-    PermutationIndexer<8> permIndexer;
-
 public:
     CornerPatternDatabase();
     CornerPatternDatabase(uint8_t init_val);
     uint32_t getDatabaseIndex(const RubiksCube& cube) const;
 
+    // While loading: the larger of the distances of the entry's corner
+    // permutation alone and of its corner twists alone
+    uint8_t getFallback(uint32_t index) const override;
+
+    // Index from a coordinate carried through CornerMoveTables
+    uint32_t getDatabaseIndex(const CornerCoordinate& coord) const {
+        return coord.getDatabaseIndex();
+    }
+
 };
 
 
@@ -0,0 +1,84 @@
+#include "Cube2x2Database.h"
+
+namespace {
+    // Corners 0..6 with D-B-L home and untwisted
+    uint16_t getPerm(const CornerCubies &corners) {
+        array<uint8_t, 7> perm;
+        copy(corners.cp.begin(), corners.cp.begin() + 7, perm.begin());
+        return PermutationIndexer<7>::rank(perm);
+    }
+
+    uint16_t getTwist(const CornerCubies &corners) {
+        uint16_t twist = 0;
+        for (int i = 0; i < 6; i++) twist = twist * 3 + corners.co[i];
+        return twist;
+    }
+
+    CornerCubies getPermState(uint16_t perm) {
+        CornerCubies corners;
+        array<uint8_t, 7> cp = PermutationIndexer<7>::unrank(perm);
+        copy(cp.begin(), cp.end(), corners.cp.begin());
+        return corners;
+    }
+
+    // The seventh twist makes the sum 0 mod 3
+    CornerCubies getTwistState(uint16_t twist) {
+        CornerCubies corners;
+        int sum = 0;
+        for (int i = 5; i >= 0; i--) {
+            corners.co[i] = twist % 3;
+            sum += corners.co[i];
+            twist /= 3;
+        }
+        corners.co[6] = (3 - sum % 3) % 3;
+        return corners;
+    }
+}
+
+Cube2x2Database::Cube2x2Database()
+    : permMoves(NUM_PERMS * NUM_MOVES), twistMoves(NUM_TWISTS * NUM_MOVES), distances(SIZE, 0xFF) {
+    for (uint16_t perm = 0; perm < NUM_PERMS; perm++) {
+        CornerCubies node = getPermState(perm);
+        for (int m = 0; m < NUM_MOVES; m++)
+            permMoves[perm * NUM_MOVES + m] = getPerm(CornerCubies::multiply(node, CornerCubies::getMove(moves[m])));
+    }
+    for (uint16_t twist = 0; twist < NUM_TWISTS; twist++) {
+        CornerCubies node = getTwistState(twist);
+        for (int m = 0; m < NUM_MOVES; m++)
+            twistMoves[twist * NUM_MOVES + m] = getTwist(CornerCubies::multiply(node, CornerCubies::getMove(moves[m])));
+    }
+
+    // Breadth-first from solved
+    uint32_t solved = getIndex(CornerCubies());
+    distances.set(solved, 0);
+    vector<uint32_t> frontier = {solved}, next;
+    for (uint8_t depth = 1; !frontier.empty(); depth++) {
+        next.clear();
+        for (uint32_t index : frontier) {
+            for (int m = 0; m < NUM_MOVES; m++) {
+                uint32_t to = move(index, m);
+                if (distances.getUnchecked(to) != 0xF) continue;
+                distances.set(to, depth);
+                next.push_back(to);
+            }
+        }
+        swap(frontier, next);
+    }
+}
+
+// r^-1 * corners has at D-B-L the cubie r^-1 sends the one there now to,
+// so the cubie at D-B-L and its twist pick the one rotation r that works
+uint32_t Cube2x2Database::getIndex(const CornerCubies &corners) const {
+    static const array<CornerCubies, 24> inverses = [] {
+        array<CornerCubies, 24> byCubie;
+        for (const CornerCubies &rotation : RubiksCube2x2::getRotations()) {
+            CornerCubies inverse = rotation.inverse();
+            for (uint8_t cubie = 0; cubie < 8; cubie++) {
+                if (inverse.cp[cubie] == 7) byCubie[cubie * 3 + (3 - inverse.co[cubie]) % 3] = inverse;
+            }
+        }
+        return byCubie;
+    }();
+    CornerCubies fixed = CornerCubies::multiply(inverses[corners.cp[7] * 3 + corners.co[7]], corners);
+    return (uint32_t) getPerm(fixed) * NUM_TWISTS + getTwist(fixed);
+}
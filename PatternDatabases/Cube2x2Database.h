@@ -0,0 +1,53 @@
+#ifndef RUBIKS_CUBE_SOLVER_CUBE2X2DATABASE_H
+#define RUBIKS_CUBE_SOLVER_CUBE2X2DATABASE_H
+
+#include "../Model/RubiksCube2x2.h"
+#include "NibbleArray.h"
+#include "PermutationIndexer.h"
+using namespace std;
+
+// Exact distance of every 2x2x2 state. Turning the cube as a whole, any
+// state can be brought to one with the D-B-L corner home and untwisted,
+// and U, R and F turns never move it again. So the table covers the 7!
+// arrangements of the other corners times the 3^6 twists of the first six
+// (the seventh follows): 3674160 entries, 1.8MB of nibbles, built by BFS
+// over move tables on construction. It is the same table as the fully
+// generated CornerPatternDatabase, folded by the 24 rotations.
+class Cube2x2Database {
+public:
+    static const int NUM_PERMS = 5040;
+    static const int NUM_TWISTS = 729;
+    static const uint32_t SIZE = NUM_PERMS * NUM_TWISTS;
+
+    // The moves that keep D-B-L in place, in MOVE order
+    static const int NUM_MOVES = 9;
+    static constexpr RubiksCube::MOVE moves[NUM_MOVES] = {
+        RubiksCube::MOVE::R, RubiksCube::MOVE::RPRIME, RubiksCube::MOVE::R2,
+        RubiksCube::MOVE::U, RubiksCube::MOVE::UPRIME, RubiksCube::MOVE::U2,
+        RubiksCube::MOVE::F, RubiksCube::MOVE::FPRIME, RubiksCube::MOVE::F2
+    };
+
+private:
+    vector<uint16_t> permMoves;     // [perm * NUM_MOVES + move]
+    vector<uint16_t> twistMoves;    // [twist * NUM_MOVES + move]
+    NibbleArray distances;
+
+public:
+    Cube2x2Database();
+
+    // Index of corners, first turned whole so D-B-L is home and untwisted.
+    // Moves that lower its distance solve corners in some orientation.
+    uint32_t getIndex(const CornerCubies &corners) const;
+
+    // Index after moves[m]
+    uint32_t move(uint32_t index, int m) const {
+        return (uint32_t) permMoves[index / NUM_TWISTS * NUM_MOVES + m] * NUM_TWISTS +
+               twistMoves[index % NUM_TWISTS * NUM_MOVES + m];
+    }
+
+    uint8_t getDistance(uint32_t index) const {
+        return distances.getUnchecked(index);
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_CUBE2X2DATABASE_H
@@ -0,0 +1,91 @@
+#include "EndgameDatabase.h"
+
+namespace {
+    // States at each distance from solved in the face-turn metric
+    const size_t statesAtDepth[8] = {
+        1, 18, 243, 3240, 43239, 574908, 7618438, 100803036
+    };
+}
+
+EndgameDatabase::EndgameDatabase(int depth) : numStates(0) {
+    if (depth < 0 || depth > 7) throw "Endgame database depth must be between 0 and 7";
+    maxDepth = depth;
+
+    // Keep the load factor at or below one half
+    size_t total = 0;
+    for (int d = 0; d <= depth; d++) total += statesAtDepth[d];
+    size_t capacity = 1;
+    while (capacity < total * 2) capacity <<= 1;
+    table.assign(capacity, {0, 0});
+    mask = capacity - 1;
+
+    insert(CubieCube().getKey(), 0, RubiksCube::MOVE::L);
+
+    // Each layer is expanded by scanning the table for the previous one.
+    // New entries carry the next distance, so the scan skips them.
+    for (int d = 1; d <= depth; d++) {
+        for (size_t slot = 0; slot < table.size(); slot++) {
+            const Entry &e = table[slot];
+            if (!(e.lo | e.hi)) continue;
+            if (((e.hi >> DISTANCE_SHIFT) & 15) != (uint64_t) d - 1) continue;
+
+            CubieCube parent = CubieCube::fromKey({e.lo, e.hi & KEY_MASK});
+            for (int i = 0; i < 18; i++) {
+                RubiksCube::MOVE m = RubiksCube::MOVE(i);
+                CubieCube child = parent;
+                child.move(m);
+                // From the child, undoing m leads back towards solved
+                insert(child.getKey(), d, RubiksCube::getInverseMove(m));
+            }
+        }
+    }
+}
+
+const EndgameDatabase::Entry* EndgameDatabase::find(const CubeKey &key) const {
+    for (size_t slot = getSlot(key);; slot = (slot + 1) & mask) {
+        const Entry &e = table[slot];
+        if (!(e.lo | e.hi)) return nullptr;
+        if (e.lo == key.lo && (e.hi & KEY_MASK) == key.hi) return &e;
+    }
+}
+
+bool EndgameDatabase::insert(const CubeKey &key, uint8_t distance, RubiksCube::MOVE next) {
+    for (size_t slot = getSlot(key);; slot = (slot + 1) & mask) {
+        Entry &e = table[slot];
+        if (!(e.lo | e.hi)) {
+            e.lo = key.lo;
+            e.hi = key.hi | ((uint64_t) distance << DISTANCE_SHIFT)
+                          | ((uint64_t) next << MOVE_SHIFT);
+            numStates++;
+            return true;
+        }
+        if (e.lo == key.lo && (e.hi & KEY_MASK) == key.hi) return false;
+    }
+}
+
+bool EndgameDatabase::lookup(const CubieCube &cube, uint8_t &distance, RubiksCube::MOVE &next) const {
+    const Entry *e = find(cube.getKey());
+    if (!e) return false;
+    distance = (e->hi >> DISTANCE_SHIFT) & 15;
+    next = RubiksCube::MOVE((e->hi >> MOVE_SHIFT) & 31);
+    return true;
+}
+
+uint8_t EndgameDatabase::getDistance(const CubieCube &cube) const {
+    uint8_t distance;
+    RubiksCube::MOVE next;
+    return lookup(cube, distance, next) ? distance : maxDepth + 1;
+}
+
+vector<RubiksCube::MOVE> EndgameDatabase::getSolution(CubieCube cube) const {
+    vector<RubiksCube::MOVE> solution;
+    uint8_t distance;
+    RubiksCube::MOVE next;
+    if (!lookup(cube, distance, next)) return solution;
+    while (distance > 0) {
+        solution.push_back(next);
+        cube.move(next);
+        lookup(cube, distance, next);
+    }
+    return solution;
+}
@@ -0,0 +1,63 @@
+#ifndef RUBIKS_CUBE_SOLVER_ENDGAMEDATABASE_H
+#define RUBIKS_CUBE_SOLVER_ENDGAMEDATABASE_H
+
+#include "../Model/RubiksCube.h"
+#include "../Model/CubieCube.h"
+using namespace std;
+
+// Every full-cube state within maxDepth moves of solved, with its exact
+// distance and the first move of an optimal solution. Searches stop as soon
+// as they reach a stored state instead of expanding its last plies; a state
+// that is not stored is at least maxDepth + 1 moves from solved.
+//
+// States are kept by CubeKey in an open-addressing table sized up front, so
+// the table also serves as the BFS queue during the build. Entry counts by
+// depth are 1, 18, 243, 3240, 43239, 574908, 7618438, 100803036: depth 6
+// takes 256MB, depth 7 4GB.
+class EndgameDatabase {
+    // Key plus payload: distance and next move live in the unused top bits
+    // of the corner word. An all-zero key is never a real state.
+    struct Entry {
+        uint64_t lo;
+        uint64_t hi;
+    };
+
+    static const int DISTANCE_SHIFT = 40;
+    static const int MOVE_SHIFT = 44;
+    static const uint64_t KEY_MASK = (1ull << DISTANCE_SHIFT) - 1;
+
+    int maxDepth;
+    vector<Entry> table;
+    uint64_t mask;          // table.size() - 1
+    size_t numStates;
+
+    size_t getSlot(const CubeKey &key) const {
+        uint64_t h = (key.lo ^ (key.hi * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return (h ^ (h >> 31)) & mask;
+    }
+
+    const Entry* find(const CubeKey &key) const;
+
+    // Store key at distance with the given next move; false if present
+    bool insert(const CubeKey &key, uint8_t distance, RubiksCube::MOVE next);
+
+public:
+    // BFS from solved out to depth (at most 7)
+    explicit EndgameDatabase(int depth = 6);
+
+    int getMaxDepth() const { return maxDepth; }
+    size_t size() const { return numStates; }
+
+    // Fill distance and next move and return true if cube is stored.
+    // For the solved cube next is meaningless.
+    bool lookup(const CubieCube &cube, uint8_t &distance, RubiksCube::MOVE &next) const;
+
+    // Lower bound on the distance of cube: exact if stored, else maxDepth + 1
+    uint8_t getDistance(const CubieCube &cube) const;
+
+    // Optimal solution of a stored cube, by following the next moves.
+    // Empty if cube is solved or not stored.
+    vector<RubiksCube::MOVE> getSolution(CubieCube cube) const;
+};
+
+#endif // RUBIKS_CUBE_SOLVER_ENDGAMEDATABASE_H
@@ -1,14 +1,22 @@
 #include "NibbleArray.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
-// Store 4-bit values packed into bytes (two nibbles per byte)
+// Store 4-bit values packed into bytes (two nibbles per byte).
+// Three extra bytes let a 32-bit gather start at the last byte.
 NibbleArray::NibbleArray(const size_t size, const uint8_t val)
-    : size(size), arr(size / 2 + 1, val) {}
+    : size(size), arr(size / 2 + 1 + 3, val) {}
 
 // Return the 4-bit value at position pos
 uint8_t NibbleArray::get(const size_t pos) const {
     size_t i = pos / 2;
     assert(pos < this->size);
-    uint8_t byte = arr.at(i);
+    uint8_t byte = bytes()[i];
     if (pos % 2) {
         return byte & 0x0F;          // low nibble
     } else {
@@ -16,32 +24,195 @@ uint8_t NibbleArray::get(const size_t pos) const {
     }
 }
 
+void NibbleArray::getBatch(span<const uint32_t> positions, span<uint8_t> out) const {
+    assert(out.size() >= positions.size());
+    size_t n = positions.size();
+    size_t i = 0;
+#ifdef __AVX2__
+    // Gather the 32-bit word starting at each byte, then shift the wanted
+    // nibble down: high nibble for even positions, low for odd ones.
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i low4 = _mm256_set1_epi32(0x0F);
+    const __m256i packBytes = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i packLanes = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+    const int *base = reinterpret_cast<const int*>(bytes());
+    for (; i + 8 <= n; i += 8) {
+        __m256i pos = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions.data() + i));
+        __m256i words = _mm256_i32gather_epi32(base, _mm256_srli_epi32(pos, 1), 1);
+        __m256i shift = _mm256_slli_epi32(_mm256_andnot_si256(pos, one), 2);
+        __m256i vals = _mm256_and_si256(_mm256_srlv_epi32(words, shift), low4);
+        vals = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(vals, packBytes), packLanes);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out.data() + i), _mm256_castsi256_si128(vals));
+    }
+#else
+    // Scalar path: prefetch a block of entries, then read it back
+    for (; i + 16 <= n; i += 16) {
+        for (size_t j = 0; j < 16; ++j) prefetch(positions[i + j]);
+        for (size_t j = 0; j < 16; ++j) out[i + j] = getUnchecked(positions[i + j]);
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = getUnchecked(positions[i]);
+    }
+}
+
 // Set the 4-bit value at position pos to val
 void NibbleArray::set(const size_t pos, const uint8_t val) {
     size_t i = pos / 2;
-    uint8_t byte = arr.at(i);
     assert(pos < this->size);
+    uint8_t byte = bytes()[i];
     if (pos % 2) {
         // Clear low nibble, then store val in low nibble
-        arr.at(i) = (byte & 0xF0) | (val & 0x0F);
+        byte = (byte & 0xF0) | (val & 0x0F);
     } else {
         // Clear high nibble, then store val in high nibble
-        arr.at(i) = (byte & 0x0F) | (val << 4);
+        byte = (byte & 0x0F) | (val << 4);
+    }
+    if (mappings.size() > 1) {
+        for (auto &copy : mappings) copy.get()[i] = byte;
+    } else {
+        bytes()[i] = byte;
     }
 }
 
 // Pointer to packed data
 uint8_t* NibbleArray::data() {
-    return arr.data();
+    return bytes();
 }
 
 const uint8_t* NibbleArray::data() const {
-    return arr.data();
+    return bytes();
 }
 
-// Bytes needed to store all nibbles
+// Bytes needed to store all nibbles (excludes the gather padding)
 size_t NibbleArray::storageSize() const {
-    return arr.size();
+    return this->size / 2 + 1;
+}
+
+// Reserve anonymous memory for the data plus gather padding, then map the
+// file over its start, so reads past the end of the file never fault.
+bool NibbleArray::mapFile(const string &filePath) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if ((size_t) st.st_size != storageSize()) {
+        close(fd);
+        throw "Database corrupt or size mismatch";
+    }
+
+    size_t length = storageSize() + 3;
+    void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    void *file = mmap(base, storageSize(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) {
+        munmap(base, length);
+        return false;
+    }
+    madvise(base, storageSize(), MADV_WILLNEED);
+
+    mappings = {shared_ptr<uint8_t>(static_cast<uint8_t*>(base),
+                                    [length](uint8_t *p) { munmap(p, length); })};
+    loading.reset();
+    vector<uint8_t>().swap(arr);
+    return true;
+}
+
+// The reader thread owns references to the storage and progress, so it
+// may outlive this array and its copies
+bool NibbleArray::loadFileAsync(const string &filePath, size_t chunkBytes) {
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t total = storageSize();
+    if ((size_t) st.st_size != total) {
+        close(fd);
+        throw "Database corrupt or size mismatch";
+    }
+
+    size_t length = total + 3;
+    void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    shared_ptr<uint8_t> storage(static_cast<uint8_t*>(base),
+                                [length](uint8_t *p) { munmap(p, length); });
+
+    auto progress = make_shared<LoadProgress>();
+    size_t numChunks = (total + chunkBytes - 1) / chunkBytes;
+    progress->chunkBytes = chunkBytes;
+    progress->chunks = make_unique<atomic<bool>[]>(numChunks);
+
+    thread([fd, storage, progress, total, numChunks] {
+        size_t chunkBytes = progress->chunkBytes;
+        int state = LoadProgress::LOADED;
+        for (size_t c = 0; c < numChunks && state == LoadProgress::LOADED; c++) {
+            size_t begin = c * chunkBytes, end = min(total, begin + chunkBytes);
+            for (size_t pos = begin; pos < end; ) {
+                ssize_t n = pread(fd, storage.get() + pos, end - pos, pos);
+                if (n <= 0) {
+                    state = LoadProgress::FAILED;
+                    break;
+                }
+                pos += n;
+            }
+            if (state == LoadProgress::LOADED) progress->chunks[c].store(true, memory_order_release);
+        }
+        close(fd);
+        progress->state.store(state, memory_order_release);
+        progress->state.notify_all();
+    }).detach();
+
+    mappings = {storage};
+    loading = progress;
+    vector<uint8_t>().swap(arr);
+    return true;
+}
+
+bool NibbleArray::waitUntilLoaded() const {
+    if (!loading) return true;
+    loading->state.wait(LoadProgress::LOADING, memory_order_acquire);
+    return loading->state.load(memory_order_acquire) == LoadProgress::LOADED;
+}
+
+// Fresh anonymous mappings get their pages placed by the policy bound to
+// them, as the copy first touches each page
+bool NibbleArray::place(NumaPolicy policy) {
+    if (policy == NumaPolicy::LOCAL) return true;
+    if (!waitUntilLoaded()) return false;
+    const NumaTopology &topology = NumaTopology::get();
+    int copies = policy == NumaPolicy::REPLICATE ? topology.getNumNodes() : 1;
+    size_t length = storageSize() + 3;
+
+    vector<shared_ptr<uint8_t>> placed;
+    for (int node = 0; node < copies; node++) {
+        void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) return false;
+        placed.emplace_back(static_cast<uint8_t*>(base),
+                            [length](uint8_t *p) { munmap(p, length); });
+        topology.bindMemory(base, length, policy == NumaPolicy::REPLICATE ? node : -1);
+        memcpy(base, bytes(), length);
+    }
+    mappings = std::move(placed);
+    loading.reset();
+    vector<uint8_t>().swap(arr);
+    return true;
 }
 
 // Expand each 4-bit value into dest vector (one byte per nibble)
@@ -54,5 +225,9 @@ void NibbleArray::inflate(vector<uint8_t>& dest) const {
 
 // Fill all nibbles with val
 void NibbleArray::reset(const uint8_t val) {
-    fill(arr.begin(), arr.end(), val);
+    if (mappings.empty()) {
+        fill(arr.begin(), arr.end(), val);
+        return;
+    }
+    for (auto &copy : mappings) fill(copy.get(), copy.get() + storageSize() + 3, val);
 }
\ No newline at end of file
@@ -2,12 +2,33 @@
 #define RUBIKS_CUBE_SOLVER_NIBBLEARRAY_H
 
 #include <bits/stdc++.h>
+#include <span>
+#include "NumaTopology.h"
 using namespace std;
 
 // Compact storage for 4-bit values
 class NibbleArray {
     size_t size;             // number of nibbles
-    vector<uint8_t> arr;     // two nibbles per byte
+    vector<uint8_t> arr;     // two nibbles per byte, plus gather padding
+    // Mappings replacing arr: a file (see mapFile()), an interleaved copy,
+    // or one copy per NUMA node (see place())
+    vector<shared_ptr<uint8_t>> mappings;
+
+    // Chunks of a file still being read in, see loadFileAsync()
+    struct LoadProgress {
+        enum State { LOADING, LOADED, FAILED };
+        size_t chunkBytes;
+        unique_ptr<atomic<bool>[]> chunks;  // chunk i has been read
+        atomic<int> state{LOADING};
+    };
+    shared_ptr<LoadProgress> loading;
+
+    const uint8_t* bytes() const {
+        if (mappings.empty()) return arr.data();
+        if (mappings.size() == 1) return mappings[0].get();
+        return mappings[NumaTopology::getThreadNode()].get();
+    }
+    uint8_t* bytes() { return const_cast<uint8_t*>(as_const(*this).bytes()); }
 
 public:
     // Construct array of given size, filled with val
@@ -16,6 +37,21 @@ public:
     // Return the nibble value at position pos
     uint8_t get(size_t pos) const;
 
+    // Same as get(), without bounds checks; pos must be < size
+    uint8_t getUnchecked(size_t pos) const {
+        uint8_t byte = bytes()[pos / 2];
+        return (pos % 2) ? (byte & 0x0F) : (byte >> 4);
+    }
+
+    // out[i] = get(positions[i]) for every i, unchecked. Uses AVX2 gathers
+    // when compiled for it.
+    void getBatch(span<const uint32_t> positions, span<uint8_t> out) const;
+
+    // Hint the cache line holding position pos into cache
+    void prefetch(size_t pos) const {
+        __builtin_prefetch(bytes() + pos / 2);
+    }
+
     // Set the nibble at position pos to val
     void set(size_t pos, uint8_t val);
 
@@ -26,6 +62,38 @@ public:
     // Total storage in bytes
     size_t storageSize() const;
 
+    // Use a file written from data() as the storage, mapped copy-on-write
+    // instead of read in: pages load on demand and are shared with every
+    // other process mapping the same file. Copies of the array share the
+    // mapping. Returns false if the file can't be opened or mapped.
+    bool mapFile(const string &filePath);
+
+    // Read a file written from data() into fresh storage on a background
+    // thread, chunkBytes at a time, and return at once. Until isLoaded(pos),
+    // the value at pos is undefined; don't set() before it is loaded.
+    // Copies of the array share the storage. Returns false if the file
+    // can't be opened or the memory reserved.
+    bool loadFileAsync(const string &filePath, size_t chunkBytes);
+
+    // Whether the value at pos is in place (always, unless loading)
+    bool isLoaded(size_t pos) const {
+        if (!loading || loading->state.load(memory_order_acquire) == LoadProgress::LOADED) return true;
+        return loading->chunks[pos / 2 / loading->chunkBytes].load(memory_order_acquire);
+    }
+
+    bool isFullyLoaded() const {
+        return !loading || loading->state.load(memory_order_acquire) == LoadProgress::LOADED;
+    }
+
+    // Block until a background load ends; false if it failed
+    bool waitUntilLoaded() const;
+
+    // Move the data to memory laid out by policy (see NumaPolicy). With
+    // REPLICATE each thread reads the copy on its node, and writes go to
+    // every copy. Waits for a background load first. Returns false if the
+    // memory can't be reserved, leaving the array as it was.
+    bool place(NumaPolicy policy);
+
     // Expand all nibbles into dest vector
     void inflate(vector<uint8_t>& dest) const;
 
@@ -0,0 +1,109 @@
+#include "NumaTopology.h"
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
+
+namespace {
+    // Parse a sysfs CPU list such as "0-3,8-11"
+    vector<int> parseCpuList(const string &list) {
+        vector<int> cpus;
+        stringstream ss(list);
+        string range;
+        while (getline(ss, range, ',')) {
+            if (range.empty() || !isdigit((unsigned char) range[0])) continue;
+            size_t dash = range.find('-');
+            int first = stoi(range.substr(0, dash));
+            int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+}
+
+// Nodes without CPUs (memory-only) are left out: no thread reads from them
+NumaTopology::NumaTopology(const string &sysfsRoot) {
+    error_code ec;
+    vector<pair<int, vector<int>>> found;
+    for (auto &entry : filesystem::directory_iterator(sysfsRoot, ec)) {
+        string name = entry.path().filename().string();
+        if (name.size() < 5 || name.compare(0, 4, "node") != 0 ||
+            !all_of(name.begin() + 4, name.end(), ::isdigit)) continue;
+        ifstream reader(entry.path() / "cpulist");
+        string list;
+        getline(reader, list);
+        vector<int> cpus = parseCpuList(list);
+        if (!cpus.empty()) found.emplace_back(stoi(name.substr(4)), cpus);
+    }
+    sort(found.begin(), found.end());
+
+    if (found.empty()) {
+        // One node with every CPU
+        vector<int> cpus(max(1u, thread::hardware_concurrency()));
+        iota(cpus.begin(), cpus.end(), 0);
+        found.emplace_back(0, cpus);
+    }
+    for (auto &[id, cpus] : found) {
+        for (int cpu : cpus) {
+            if (cpu >= (int) cpuNodes.size()) cpuNodes.resize(cpu + 1, 0);
+            cpuNodes[cpu] = (int) nodeIds.size();
+        }
+        nodeIds.push_back(id);
+        nodeCpus.push_back(cpus);
+    }
+}
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology topology;
+    return topology;
+}
+
+int NumaTopology::getNodeOfCpu(int cpu) const {
+    return cpu >= 0 && cpu < (int) cpuNodes.size() ? cpuNodes[cpu] : 0;
+}
+
+int NumaTopology::findThreadNode() {
+#ifdef __linux__
+    return get().getNodeOfCpu(sched_getcpu());
+#else
+    return 0;
+#endif
+}
+
+bool NumaTopology::pinThread(int node) const {
+    if (node < 0 || node >= getNumNodes()) return false;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : nodeCpus[node]) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) return false;
+    threadNode = node;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// mbind through the raw system call, which is all libnuma does
+bool NumaTopology::bindMemory(void *addr, size_t length, int node) const {
+#ifdef __linux__
+    const size_t BITS = 8 * sizeof(unsigned long);
+    int maxId = *max_element(nodeIds.begin(), nodeIds.end());
+    vector<unsigned long> mask(maxId / BITS + 1, 0);
+    for (int i = 0; i < getNumNodes(); i++) {
+        if (node >= 0 && i != node) continue;
+        mask[nodeIds[i] / BITS] |= 1ul << (nodeIds[i] % BITS);
+    }
+    int mode = node >= 0 ? MPOL_BIND : MPOL_INTERLEAVE;
+    // mbind wants whole pages; mappings start page-aligned
+    long page = sysconf(_SC_PAGESIZE);
+    length = (length + page - 1) / page * page;
+    return syscall(SYS_mbind, addr, length, mode, mask.data(), mask.size() * BITS + 1, 0) == 0;
+#else
+    return false;
+#endif
+}
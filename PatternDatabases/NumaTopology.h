@@ -0,0 +1,60 @@
+#ifndef RUBIKS_CUBE_SOLVER_NUMATOPOLOGY_H
+#define RUBIKS_CUBE_SOLVER_NUMATOPOLOGY_H
+
+#include <bits/stdc++.h>
+using namespace std;
+
+// How a read-only table is laid out over NUMA nodes
+enum class NumaPolicy {
+    LOCAL,          // pages on the node that first touches them
+    INTERLEAVE,     // one copy, pages spread round-robin over all nodes
+    REPLICATE       // one copy per node; each thread reads its own node's
+};
+
+// NUMA nodes and their CPUs, read from /sys/devices/system/node so no
+// libnuma is needed. Without that directory (or off Linux) the machine is
+// a single node holding every CPU.
+class NumaTopology {
+    vector<int> nodeIds;            // kernel node number of each node
+    vector<vector<int>> nodeCpus;
+    vector<int> cpuNodes;           // node of each CPU
+
+    static inline thread_local int threadNode = -1;
+
+public:
+    explicit NumaTopology(const string &sysfsRoot = "/sys/devices/system/node");
+
+    // The host's topology, read once
+    static const NumaTopology& get();
+
+    int getNumNodes() const {
+        return (int) nodeCpus.size();
+    }
+
+    const vector<int>& getCpus(int node) const {
+        return nodeCpus[node];
+    }
+
+    // 0 for CPUs the topology does not list
+    int getNodeOfCpu(int cpu) const;
+
+    // Node whose memory the calling thread reads: the one it was pinned
+    // to, otherwise the one it ran on when first asked
+    static int getThreadNode() {
+        if (threadNode < 0) threadNode = findThreadNode();
+        return threadNode;
+    }
+
+    static int findThreadNode();
+
+    // Run the calling thread on node's CPUs only, and read that node's
+    // replicas. Returns false if the thread could not be pinned.
+    bool pinThread(int node) const;
+
+    // Place the pages of a fresh mapping before they are first touched: on
+    // node, or interleaved over every node if node is -1. Returns false if
+    // the kernel refused; the memory is still usable.
+    bool bindMemory(void *addr, size_t length, int node) const;
+};
+
+#endif // RUBIKS_CUBE_SOLVER_NUMATOPOLOGY_H
@@ -35,6 +35,7 @@ bool PatternDatabase::setNumMoves(const RubiksCube &cube, const uint8_t numMoves
 
 // Get move count at index
 uint8_t PatternDatabase::getNumMoves(const uint32_t ind) const {
+    if (!this->database.isLoaded(ind)) return this->getFallback(ind);
     return this->database.get(ind);
 }
 
@@ -43,6 +44,18 @@ uint8_t PatternDatabase::getNumMoves(const RubiksCube &cube) const {
     return this->getNumMoves(this->getDatabaseIndex(cube));
 }
 
+void PatternDatabase::prefetch(const uint32_t ind) const {
+    this->database.prefetch(ind);
+}
+
+void PatternDatabase::getNumMoves(span<const uint32_t> indices, span<uint8_t> out) const {
+    if (!this->database.isFullyLoaded()) {
+        for (size_t i = 0; i < indices.size(); ++i) out[i] = this->getNumMoves(indices[i]);
+        return;
+    }
+    this->database.getBatch(indices, out);
+}
+
 size_t PatternDatabase::getSize() const {
     return this->size;
 }
@@ -69,9 +82,20 @@ void PatternDatabase::toFile(const string &filePath) const {
     writer.close();
 }
 
-// Load raw database bytes from file.
+void PatternDatabase::toCompressedFile(const string &filePath) const {
+    BlockCompressedFile::write(filePath, this->database.data(), this->database.storageSize());
+}
+
+// Load raw or block-compressed database bytes from file.
 // Returns true on success, false if file can't be opened.
 bool PatternDatabase::fromFile(const string &filePath) {
+    if (BlockCompressedFile::isCompressed(filePath)) {
+        if (!BlockCompressedFile::read(filePath, this->database.data(), this->database.storageSize()))
+            return false;
+        this->numItems = this->size;
+        return true;
+    }
+
     ifstream reader(filePath, ios::in | ios::ate);
     if (!reader.is_open())
         return false;
@@ -92,6 +116,41 @@ bool PatternDatabase::fromFile(const string &filePath) {
     return true;
 }
 
+bool PatternDatabase::loadFileAsync(const string &filePath) {
+    if (BlockCompressedFile::isCompressed(filePath))
+        return this->fromFile(filePath);
+    if (!this->database.loadFileAsync(filePath, LOAD_CHUNK_BYTES))
+        return false;
+    this->numItems = this->size;
+    return true;
+}
+
+bool PatternDatabase::isLoaded() const {
+    return this->database.isFullyLoaded();
+}
+
+bool PatternDatabase::waitUntilLoaded() const {
+    return this->database.waitUntilLoaded();
+}
+
+// 0 bounds any distance
+uint8_t PatternDatabase::getFallback(const uint32_t) const {
+    return 0;
+}
+
+bool PatternDatabase::mapFile(const string &filePath) {
+    if (BlockCompressedFile::isCompressed(filePath))
+        return this->fromFile(filePath);
+    if (!this->database.mapFile(filePath))
+        return false;
+    this->numItems = this->size;
+    return true;
+}
+
+bool PatternDatabase::place(NumaPolicy policy) {
+    return this->database.place(policy);
+}
+
 // Return a vector of decompressed byte values
 vector<uint8_t> PatternDatabase::inflate() const {
     vector<uint8_t> inflated;
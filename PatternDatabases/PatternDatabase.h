@@ -3,11 +3,16 @@
 
 #include "../Model/RubiksCube.h"
 #include "NibbleArray.h"
+#include "BlockCompressedFile.h"
 #include <vector>
 #include <string>
+#include <span>
+#include <concepts>
 
 // Abstract base for a pattern database used by the Rubik's Cube solver
 class PatternDatabase {
+    static const size_t LOAD_CHUNK_BYTES = 1 << 20;
+
     NibbleArray database;
     size_t size;
     size_t numItems;
@@ -36,6 +41,26 @@ public:
     // Retrieve stored move count by index
     virtual uint8_t getNumMoves(uint32_t index) const;
 
+    // Start loading the entry at index into cache ahead of a lookup
+    void prefetch(uint32_t index) const;
+
+    // Batched lookup: out[i] = moves stored at indices[i]. Skips the
+    // per-entry virtual call and bounds check of getNumMoves(index).
+    void getNumMoves(span<const uint32_t> indices, span<uint8_t> out) const;
+
+    // Batched lookup for an array of cubes of one concrete model
+    template<typename T> requires derived_from<T, RubiksCube>
+    void getNumMoves(span<const T> cubes, span<uint8_t> out) const {
+        uint32_t indices[64];
+        for (size_t i = 0; i < cubes.size(); i += 64) {
+            size_t n = min<size_t>(64, cubes.size() - i);
+            for (size_t j = 0; j < n; ++j) {
+                indices[j] = this->getDatabaseIndex(cubes[i + j]);
+            }
+            this->getNumMoves(span<const uint32_t>(indices, n), out.subspan(i, n));
+        }
+    }
+
     // Total number of entries (capacity)
     virtual size_t getSize() const;
 
@@ -48,9 +73,38 @@ public:
     // Write database to a file
     virtual void toFile(const std::string &filePath) const;
 
-    // Load database from a file
+    // Write database to a block-compressed file (see BlockCompressedFile),
+    // which every load below also accepts
+    virtual void toCompressedFile(const std::string &filePath) const;
+
+    // Load database from a file, decompressing it on every CPU if it is
+    // block-compressed
     virtual bool fromFile(const std::string &filePath);
 
+    // Start reading a database file in the background and return at once.
+    // Until its chunk arrives, an entry reads as getFallback(), so searches
+    // can start right away and sharpen as the load goes on. A compressed
+    // file is decompressed before returning instead. Returns false if the
+    // file can't be opened.
+    virtual bool loadFileAsync(const std::string &filePath);
+
+    // Whether every entry is in place; waitUntilLoaded() blocks until
+    // then, and returns false if the load failed
+    bool isLoaded() const;
+    bool waitUntilLoaded() const;
+
+    // Lower bound returned for an entry not loaded yet
+    virtual uint8_t getFallback(uint32_t index) const;
+
+    // Map a database file into memory instead of reading it (see
+    // NibbleArray::mapFile); for long-running processes sharing one file.
+    // A compressed file can't be mapped, so it is read as by fromFile().
+    virtual bool mapFile(const std::string &filePath);
+
+    // Lay the loaded entries out over NUMA nodes (see NumaPolicy); false
+    // if the memory can't be reserved
+    virtual bool place(NumaPolicy policy);
+
     // Expand compressed data into a raw byte vector
     virtual std::vector<uint8_t> inflate() const;
 
@@ -2,55 +2,112 @@
 #define RUBIKS_CUBE_SOLVER_PERMUTATIONINDEXER_H
 
 #include <bits/stdc++.h>
-#include <cmath>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 using namespace std;
 
+// Lexicographic rank of K-length permutations of N items, and back.
+// Tables are computed at compile time and shared by every user; the
+// functions are static, so no instance is needed.
 template <size_t N, size_t K = N>
 class PermutationIndexer
 {
-    // Number of 1-bits for each number up to (1<<N)-1
-    array<uint32_t, (1 << N) - 1> onesCountLookup;
+    static_assert(K <= N && N <= 16, "PermutationIndexer supports up to 16 items");
 
-    // Factorials or "n choose k" values, reversed
-    array<uint32_t, K> factorials;
+    // Number of 1-bits for each number below 1 << N, for targets without
+    // a popcount instruction
+    static constexpr array<uint8_t, (1 << N)> onesCountLookup = [] {
+        array<uint8_t, (1 << N)> counts{};
+        for (uint32_t i = 1; i < (1 << N); ++i) counts[i] = counts[i >> 1] + (i & 1);
+        return counts;
+    }();
 
-public:
-    // Build lookup tables for bit counts and factorials/picks
-    PermutationIndexer()
-    {
-        for (uint32_t i = 0; i < (1 << N) - 1; ++i) {
-            onesCountLookup[i] = bitset<N>(i).count();
-        }
+    // Place values of the Lehmer digits: (N-1-i) pick (K-1-i)
+    static constexpr array<uint32_t, K> factorials = [] {
+        array<uint32_t, K> picks{};
         for (uint32_t i = 0; i < K; ++i) {
-            factorials[i] = pick(N - 1 - i, K - 1 - i);
+            picks[i] = 1;
+            for (uint32_t j = 0; j < K - 1 - i; ++j) picks[i] *= N - 1 - i - j;
         }
+        return picks;
+    }();
+
+    static constexpr uint32_t countOnes(uint32_t bits)
+    {
+#ifdef __POPCNT__
+        return popcount(bits);
+#else
+        return onesCountLookup[bits];
+#endif
     }
 
-    // Compute lexicographic index of a K-length permutation over N items
-    uint32_t rank(const array<uint8_t, K>& perm) const
+    // Position of the n-th (from 0) set bit of bits
+    static constexpr uint32_t selectBit(uint32_t bits, uint32_t n)
     {
-        array<uint32_t, K> lehmer{};  // Lehmer code
-        bitset<N> seen;               // Tracks which numbers have appeared
-
-        // First Lehmer digit is the value itself
-        lehmer[0] = perm[0];
-        seen.set(N - 1 - perm[0]);
-
-        for (uint32_t i = 1; i < K; ++i) {
-            seen.set(N - 1 - perm[i]);
-            // Count how many smaller values have already been seen
-            uint32_t mask = seen.to_ulong() >> (N - perm[i]);
-            uint32_t numSeenLeft = onesCountLookup[mask];
-            lehmer[i] = perm[i] - numSeenLeft;
-        }
+#ifdef __BMI2__
+        if (!is_constant_evaluated()) return countr_zero(_pdep_u32(1u << n, bits));
+#endif
+        for (; n > 0; --n) bits &= bits - 1;
+        return countr_zero(bits);
+    }
 
-        // Convert Lehmer code to a single index
+public:
+    // Number of distinct permutations: N pick K
+    static constexpr uint32_t size = factorials[0] * N;
+
+    // Compute lexicographic index of a K-length permutation over N items
+    static constexpr uint32_t rank(const array<uint8_t, K>& perm)
+    {
+        uint32_t seen = 0;       // bit v set once value v has appeared
         uint32_t index = 0;
         for (uint32_t i = 0; i < K; ++i) {
-            index += lehmer[i] * factorials[i];
+            // Lehmer digit: the value less the smaller values already used
+            uint32_t smallerSeen = countOnes(seen & ((1u << perm[i]) - 1));
+            index += (perm[i] - smallerSeen) * factorials[i];
+            seen |= 1u << perm[i];
         }
         return index;
     }
+
+    // The permutation with lexicographic index, inverse of rank()
+    static constexpr array<uint8_t, K> unrank(uint32_t index)
+    {
+        array<uint8_t, K> perm{};
+        uint32_t unused = (1u << N) - 1;
+        for (uint32_t i = 0; i < K; ++i) {
+            // The digit-th smallest value not used yet
+            uint32_t value = selectBit(unused, index / factorials[i]);
+            index %= factorials[i];
+            perm[i] = value;
+            unused &= ~(1u << value);
+        }
+        return perm;
+    }
+
+    // Rank many permutations. Four are ranked side by side, so their
+    // serial bit-count chains overlap.
+    static void rankBatch(span<const array<uint8_t, K>> perms, span<uint32_t> out)
+    {
+        assert(out.size() >= perms.size());
+        size_t n = perms.size();
+        size_t p = 0;
+        for (; p + 4 <= n; p += 4) {
+            uint32_t seen[4] = {0, 0, 0, 0};
+            uint32_t index[4] = {0, 0, 0, 0};
+            for (uint32_t i = 0; i < K; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    uint8_t value = perms[p + j][i];
+                    index[j] += (value - countOnes(seen[j] & ((1u << value) - 1))) * factorials[i];
+                    seen[j] |= 1u << value;
+                }
+            }
+            for (int j = 0; j < 4; ++j) out[p + j] = index[j];
+        }
+        for (; p < n; ++p) {
+            out[p] = rank(perms[p]);
+        }
+    }
 };
 
-#endif // RUBIKS_CUBE_SOLVER_PERMUTATIONINDEXER_H
\ No newline at end of file
+#endif // RUBIKS_CUBE_SOLVER_PERMUTATIONINDEXER_H
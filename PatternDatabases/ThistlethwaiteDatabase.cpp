@@ -0,0 +1,315 @@
+#include "ThistlethwaiteDatabase.h"
+#include "PermutationIndexer.h"
+#include "math.h"
+
+namespace {
+    // Edge positions of each slice: M between L and R, S between F and B,
+    // E between U and D. Cubies are numbered by their home position.
+    const uint8_t sliceEdges[3][4] = {{0, 2, 8, 10}, {1, 3, 9, 11}, {4, 5, 6, 7}};
+    const uint8_t nonESliceEdges[8] = {0, 1, 2, 3, 8, 9, 10, 11};
+
+    bool isESliceEdge(uint8_t edge) {
+        return edge >= 4 && edge <= 7;
+    }
+
+    bool isMSliceEdge(uint8_t edge) {
+        return edge == 0 || edge == 2 || edge == 8 || edge == 10;
+    }
+
+    // Colex rank of the positions marked in mask among n: sum of
+    // C(p, j) over its j-th smallest position p, from j = 1
+    uint32_t rankSubset(uint32_t mask, int n) {
+        uint32_t rank = 0;
+        for (int p = 0, j = 0; p < n; p++)
+            if (mask >> p & 1) rank += choose(p, ++j);
+        return rank;
+    }
+
+    uint32_t unrankSubset(uint32_t rank, int n, int k) {
+        uint32_t mask = 0;
+        for (int p = n - 1; p >= 0 && k > 0; p--) {
+            if (choose(p, k) <= rank) {
+                rank -= choose(p, k);
+                mask |= 1u << p;
+                k--;
+            }
+        }
+        return mask;
+    }
+
+    // Parity of the 4-item permutation of rank: that of its Lehmer digits' sum
+    int getParity4(uint32_t rank) {
+        return (rank / 6 + rank / 2 % 3 + rank % 2) & 1;
+    }
+
+    // The 96 corner permutations of G3, and the cosets of that group:
+    // corners X and h * X (h in the group) lie the same number of moves
+    // from it, whichever moves follow
+    struct HalfTurnCorners {
+        vector<uint16_t> members;       // perm ranks, sorted
+        vector<uint16_t> cosetOf;       // [perm rank]
+        vector<uint16_t> cosetRep;      // a perm rank of each coset
+
+        HalfTurnCorners() : cosetOf(40320, 0xFFFF) {
+            typedef array<uint8_t, 8> Perm;
+            auto corners = [](const Perm &cp) {
+                CornerCubies res;
+                res.cp = cp;
+                return res;
+            };
+            vector<Perm> group = {CornerCubies().cp};
+            set<uint32_t> seen = {PermutationIndexer<8>::rank(group[0])};
+            for (size_t i = 0; i < group.size(); i++) {
+                for (auto m : {RubiksCube::MOVE::L2, RubiksCube::MOVE::R2, RubiksCube::MOVE::U2,
+                               RubiksCube::MOVE::D2, RubiksCube::MOVE::F2, RubiksCube::MOVE::B2}) {
+                    Perm next = CornerCubies::multiply(corners(group[i]), CornerCubies::getMove(m)).cp;
+                    if (seen.insert(PermutationIndexer<8>::rank(next)).second) group.push_back(next);
+                }
+            }
+            members.assign(seen.begin(), seen.end());
+
+            for (uint16_t rank = 0; rank < 40320; rank++) {
+                if (cosetOf[rank] != 0xFFFF) continue;
+                CornerCubies x = corners(PermutationIndexer<8>::unrank(rank));
+                for (const Perm &h : group) {
+                    uint16_t other = PermutationIndexer<8>::rank(CornerCubies::multiply(corners(h), x).cp);
+                    cosetOf[other] = cosetRep.size();
+                }
+                cosetRep.push_back(rank);
+            }
+        }
+    };
+
+    const HalfTurnCorners& getHalfTurnCorners() {
+        static const HalfTurnCorners corners;
+        return corners;
+    }
+
+    // One half of a phase coordinate: its number of values, its value for
+    // a cube, and a cube with a given value
+    struct Part {
+        uint32_t size;
+        uint32_t (*encode)(const CubieCube&);
+        CubieCube (*decode)(uint32_t);
+    };
+
+    const Part none = {
+        1,
+        [](const CubieCube&) { return 0u; },
+        [](uint32_t) { return CubieCube(); }
+    };
+
+    // Flips of edges 0..10; the last makes the count even
+    const Part flips = {
+        2048,
+        [](const CubieCube &cube) {
+            uint32_t value = 0;
+            for (int i = 0; i < 11; i++) value |= cube.edges.eo[i] << i;
+            return value;
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            for (int i = 0; i < 11; i++) cube.edges.eo[i] = value >> i & 1;
+            cube.edges.eo[11] = popcount(value) & 1;
+            return cube;
+        }
+    };
+
+    // Twists of corners 0..6 in base 3; the last makes the sum 0 mod 3
+    const Part twists = {
+        2187,
+        [](const CubieCube &cube) {
+            uint32_t value = 0;
+            for (int i = 0; i < 7; i++) value = value * 3 + cube.corners.co[i];
+            return value;
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            int sum = 0;
+            for (int i = 6; i >= 0; i--) {
+                cube.corners.co[i] = value % 3;
+                sum += value % 3;
+                value /= 3;
+            }
+            cube.corners.co[7] = (3 - sum % 3) % 3;
+            return cube;
+        }
+    };
+
+    // Positions holding the four E-slice edges
+    const Part eSlice = {
+        495,
+        [](const CubieCube &cube) {
+            uint32_t mask = 0;
+            for (int i = 0; i < 12; i++)
+                if (isESliceEdge(cube.edges.ep[i])) mask |= 1u << i;
+            return rankSubset(mask, 12);
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            uint32_t mask = unrankSubset(value, 12, 4);
+            uint8_t nextE = 4, nextOther = 0;
+            for (int i = 0; i < 12; i++) {
+                if (mask >> i & 1) {
+                    cube.edges.ep[i] = nextE++;
+                } else {
+                    cube.edges.ep[i] = nextOther++;
+                    if (nextOther == 4) nextOther = 8;
+                }
+            }
+            return cube;
+        }
+    };
+
+    const Part cornerCoset = {
+        420,
+        [](const CubieCube &cube) {
+            return (uint32_t) getHalfTurnCorners().cosetOf[PermutationIndexer<8>::rank(cube.corners.cp)];
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            cube.corners.cp = PermutationIndexer<8>::unrank(getHalfTurnCorners().cosetRep[value]);
+            return cube;
+        }
+    };
+
+    // Which of the eight positions outside the E slice hold M-slice edges
+    const Part mSlice = {
+        70,
+        [](const CubieCube &cube) {
+            uint32_t mask = 0;
+            for (int j = 0; j < 8; j++)
+                if (isMSliceEdge(cube.edges.ep[nonESliceEdges[j]])) mask |= 1u << j;
+            return rankSubset(mask, 8);
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            uint32_t mask = unrankSubset(value, 8, 4);
+            int nextM = 0, nextS = 0;
+            for (int j = 0; j < 8; j++)
+                cube.edges.ep[nonESliceEdges[j]] = mask >> j & 1 ? sliceEdges[0][nextM++] : sliceEdges[1][nextS++];
+            return cube;
+        }
+    };
+
+    const Part cornerPerm = {
+        96,
+        [](const CubieCube &cube) {
+            const vector<uint16_t> &members = getHalfTurnCorners().members;
+            uint16_t rank = PermutationIndexer<8>::rank(cube.corners.cp);
+            return (uint32_t) (lower_bound(members.begin(), members.end(), rank) - members.begin());
+        },
+        [](uint32_t value) {
+            CubieCube cube;
+            cube.corners.cp = PermutationIndexer<8>::unrank(getHalfTurnCorners().members[value]);
+            return cube;
+        }
+    };
+
+    // Permutation of each slice's edges within it. Corners of G3 are even,
+    // so the edges are too, and the E slice's permutation needs only the
+    // rank pair (2k, 2k + 1) it lies in: the two differ in parity.
+    const Part slicePerms = {
+        6912,
+        [](const CubieCube &cube) {
+            uint32_t ranks[3];
+            for (int s = 0; s < 3; s++) {
+                array<uint8_t, 4> perm;
+                for (int j = 0; j < 4; j++)
+                    perm[j] = find(sliceEdges[s], sliceEdges[s] + 4, cube.edges.ep[sliceEdges[s][j]]) - sliceEdges[s];
+                ranks[s] = PermutationIndexer<4>::rank(perm);
+            }
+            return (ranks[0] * 24 + ranks[1]) * 12 + ranks[2] / 2;
+        },
+        [](uint32_t value) {
+            uint32_t ranks[3] = {value / 12 / 24, value / 12 % 24, value % 12 * 2};
+            ranks[2] += getParity4(ranks[0]) ^ getParity4(ranks[1]) ^ getParity4(ranks[2]);
+            CubieCube cube;
+            for (int s = 0; s < 3; s++) {
+                array<uint8_t, 4> perm = PermutationIndexer<4>::unrank(ranks[s]);
+                for (int j = 0; j < 4; j++) cube.edges.ep[sliceEdges[s][j]] = sliceEdges[s][perm[j]];
+            }
+            return cube;
+        }
+    };
+
+    // Coordinate of phase p: parts[p][0] * parts[p][1].size + parts[p][1]
+    const Part* const parts[4][2] = {
+        {&flips, &none},
+        {&twists, &eSlice},
+        {&cornerCoset, &mSlice},
+        {&cornerPerm, &slicePerms},
+    };
+
+    // [value * moves + m]: the part's value after moves[m]
+    vector<uint16_t> buildMoveTable(const Part &part, const vector<RubiksCube::MOVE> &moves) {
+        vector<uint16_t> table(part.size * moves.size());
+        for (uint32_t value = 0; value < part.size; value++) {
+            CubieCube cube = part.decode(value);
+            for (size_t m = 0; m < moves.size(); m++) {
+                CubieCube next = cube;
+                next.move(moves[m]);
+                table[value * moves.size() + m] = part.encode(next);
+            }
+        }
+        return table;
+    }
+}
+
+size_t ThistlethwaiteDatabase::getPhaseSize(int phase) {
+    return (size_t) parts[phase][0]->size * parts[phase][1]->size;
+}
+
+const vector<RubiksCube::MOVE>& ThistlethwaiteDatabase::getMoves(int phase) {
+    typedef RubiksCube::MOVE M;
+    static const vector<RubiksCube::MOVE> moves[4] = {
+        {M::L, M::LPRIME, M::L2, M::R, M::RPRIME, M::R2, M::U, M::UPRIME, M::U2,
+         M::D, M::DPRIME, M::D2, M::F, M::FPRIME, M::F2, M::B, M::BPRIME, M::B2},
+        {M::L, M::LPRIME, M::L2, M::R, M::RPRIME, M::R2, M::U, M::UPRIME, M::U2,
+         M::D, M::DPRIME, M::D2, M::F2, M::B2},
+        {M::L2, M::R2, M::U, M::UPRIME, M::U2, M::D, M::DPRIME, M::D2, M::F2, M::B2},
+        {M::L2, M::R2, M::U2, M::D2, M::F2, M::B2},
+    };
+    return moves[phase];
+}
+
+uint32_t ThistlethwaiteDatabase::getCoordinate(int phase, const CubieCube &cube) {
+    return parts[phase][0]->encode(cube) * parts[phase][1]->size + parts[phase][1]->encode(cube);
+}
+
+// Level by level over the whole table rather than from a queue, to keep
+// the build's memory to the move tables. Every coordinate is reachable,
+// so whatever is left unset after depth 14 is 15 moves away, which reads
+// back as the unset value 0xF (only phase 3 goes that deep).
+ThistlethwaiteDatabase::ThistlethwaiteDatabase(int phase)
+    : PatternDatabase(getPhaseSize(phase)), phase(phase) {
+    const Part &high = *parts[phase][0], &low = *parts[phase][1];
+    const vector<RubiksCube::MOVE> &moves = getMoves(phase);
+    size_t numMoves = moves.size();
+    vector<uint16_t> highMoves = buildMoveTable(high, moves);
+    vector<uint16_t> lowMoves = buildMoveTable(low, moves);
+
+    setNumMoves(getCoordinate(phase, CubieCube()), 0);
+    for (uint8_t depth = 1; depth < 15 && getNumItems() < getSize(); depth++) {
+        for (uint32_t index = 0; index < getSize(); index++) {
+            if (getNumMoves(index) != depth - 1) continue;
+            uint32_t h = index / low.size, l = index % low.size;
+            for (size_t m = 0; m < numMoves; m++) {
+                uint32_t next = highMoves[h * numMoves + m] * low.size + lowMoves[l * numMoves + m];
+                if (getNumMoves(next) == 0xF) setNumMoves(next, depth);
+            }
+        }
+    }
+}
+
+const ThistlethwaiteDatabase& ThistlethwaiteDatabase::getInstance(int phase) {
+    static const ThistlethwaiteDatabase databases[NUM_PHASES] = {
+        ThistlethwaiteDatabase(0), ThistlethwaiteDatabase(1),
+        ThistlethwaiteDatabase(2), ThistlethwaiteDatabase(3)
+    };
+    return databases[phase];
+}
+
+uint32_t ThistlethwaiteDatabase::getDatabaseIndex(const RubiksCube &cube) const {
+    return getCoordinate(phase, CubieCube::fromCube(cube));
+}
@@ -0,0 +1,58 @@
+#ifndef RUBIKS_CUBE_SOLVER_THISTLETHWAITEDATABASE_H
+#define RUBIKS_CUBE_SOLVER_THISTLETHWAITEDATABASE_H
+
+#include "PatternDatabase.h"
+#include "../Model/CubieCube.h"
+using namespace std;
+
+// Exact distances for one phase of Thistlethwaite's algorithm, which
+// solves through the nested groups
+//   G0 = <L, R, U, D, F, B>
+//   G1 = <L, R, U, D, F2, B2>      every edge unflipped
+//   G2 = <L2, R2, U, D, F2, B2>    corners untwisted, E-slice edges in it
+//   G3 = <L2, R2, U2, D2, F2, B2>  every cubie in its half-turn orbit
+//   G4 = solved
+// Phase p (0..3) moves a cube from G(p) into G(p+1) with the moves of
+// G(p). Its table holds, for every coset of G(p+1) in G(p), the fewest
+// such moves to G(p+1); the coordinates number exactly those cosets:
+//   0: edge flips                                      2048
+//   1: corner twists x E-slice edge positions          2187 * 495
+//   2: corner coset of G3's 96 corner permutations
+//      x M-slice edge positions outside the E slice    420 * 70
+//   3: corner permutation in G3 x each slice's edge
+//      permutation, the E slice's halved by parity     96 * 6912
+// Together 1.8M entries, under 1MB as nibbles.
+class ThistlethwaiteDatabase : public PatternDatabase {
+    int phase;
+
+public:
+    static const int NUM_PHASES = 4;
+
+    // Number of coordinates of phase
+    static size_t getPhaseSize(int phase);
+
+    // The moves of G(phase), in MOVE order
+    static const vector<RubiksCube::MOVE>& getMoves(int phase);
+
+    // Coordinate of cube, which must be in G(phase)
+    static uint32_t getCoordinate(int phase, const CubieCube &cube);
+
+    // Build the phase's table: breadth-first from G(phase + 1) over move
+    // tables of the coordinates' two halves, freed once done
+    explicit ThistlethwaiteDatabase(int phase);
+
+    // The four tables, built once on first use and shared
+    static const ThistlethwaiteDatabase& getInstance(int phase);
+
+    int getPhase() const {
+        return phase;
+    }
+
+    uint32_t getDatabaseIndex(const RubiksCube &cube) const override;
+
+    uint32_t getDatabaseIndex(const CubieCube &cube) const {
+        return getCoordinate(phase, cube);
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_THISTLETHWAITEDATABASE_H
@@ -0,0 +1,218 @@
+#ifndef RUBIKS_CUBE_SOLVER_SOLVESERVICE_H
+#define RUBIKS_CUBE_SOLVER_SOLVESERVICE_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../Solver/IDAstarSolver.h"
+#include "../Solver/SolutionCache.h"
+#include "../Solver/SolutionSimplifier.h"
+#include "../Solver/SolveScheduler.h"
+
+// Solves cubes with IDA* over databases loaded once. Each solve runs as a
+// coroutine on a SolveScheduler, a slice of SLICE_NODES nodes at a time, so
+// a few worker threads take turns on every request in flight and a hard
+// scramble does not hold up the easy ones behind it.
+// Every request has a deadline and can be cancelled, which also stops its
+// search if it is running. Its callback runs exactly once, on a worker or
+// timer thread, as soon as the request is solved, times out or is
+// cancelled, so results stream out in completion order. Anytime requests
+// report the best solution found by their deadline instead of timing out.
+// T: cube representation; H: hash functor for T.
+
+template<typename T, typename H>
+class SolveService {
+public:
+    // BEST: anytime request stopped by its deadline; shortest found, not
+    // proven optimal. FAILED: the solve threw (e.g. out of memory).
+    enum class Status { SOLVED, BEST, TIMEOUT, CANCELLED, FAILED };
+    typedef chrono::steady_clock Clock;
+    typedef function<void(Status, const vector<RubiksCube::MOVE>&)> Callback;
+
+private:
+    struct Job {
+        uint64_t ticket;
+        T cube;
+        SearchLimit limit;              // deadline, and cancellation
+        bool anytime;
+        Callback done;
+        uint64_t task = 0;              // scheduler id
+        atomic<bool> started{false};    // its search began
+        atomic<bool> finished{false};   // callback already ran
+        bool expedited = false;         // raised for being past its deadline
+
+        Job(uint64_t t, const T &c, Clock::time_point d, bool a, Callback cb)
+            : ticket(t), cube(c), limit(d), anytime(a), done(std::move(cb)) {}
+    };
+
+    CornerHeuristic heuristic;
+    const EndgameDatabase *endgame;
+    SolutionCache *cache;
+    TranspositionTable *table;
+
+    mutex lock;
+    condition_variable deadlineChanged;   // timer waits for the next deadline
+    unordered_map<uint64_t, shared_ptr<Job>> active;   // queued or running
+    uint64_t nextTicket = 1;
+    uint64_t submissions = 0;             // wakes the timer for new deadlines
+    bool stopping = false;
+    unique_ptr<SolveScheduler> scheduler;
+    thread timer;
+
+    // Report a result unless one was reported already. The callback is
+    // released right after, so whatever it holds does not wait for a
+    // late solve to end.
+    static void finish(Job &job, Status status, const vector<RubiksCube::MOVE> &moves = {}) {
+        if (job.finished.exchange(true)) return;
+        job.done(status, moves);
+        job.done = nullptr;
+    }
+
+    // The coroutine solving job; it yields between slices and stops early
+    // once the job is reported, by a cancel or a timeout while queued. A
+    // solve that throws is reported FAILED.
+    SolveTask run(shared_ptr<Job> job) {
+        bool failed = false;
+        try {
+            if (!job->finished) {
+                job->started = true;
+                vector<RubiksCube::MOVE> moves;
+                if (cache && cache->lookup(job->cube, moves)) {
+                    finish(*job, Status::SOLVED, moves);
+                } else {
+                    IDAstarSolver<T, H> solver(job->cube, heuristic);
+                    solver.setEndgameDatabase(endgame);
+                    if (table) solver.setTranspositionTable(table);
+                    solver.setSearchLimit(&job->limit);
+                    SolveTask search = job->anytime ? solver.solveAnytimeSteps(SLICE_NODES)
+                                                    : solver.solveSteps(SLICE_NODES);
+                    bool abandoned = false;
+                    while (search.next()) {
+                        if ((abandoned = job->finished)) break;
+                        co_yield search.getProgress();
+                    }
+                    if (!abandoned) {
+                        // Anytime passes may return sequences an optimal one would not
+                        moves = SolutionSimplifier::simplify(search.getResult());
+                        if (!solver.isStopped()) {
+                            if (cache) cache->insert(job->cube, moves);
+                            finish(*job, Status::SOLVED, moves);
+                        } else if (job->limit.isCancelled()) {
+                            finish(*job, Status::CANCELLED);
+                        } else {
+                            finish(*job, moves.empty() ? Status::TIMEOUT : Status::BEST, moves);
+                        }
+                    }
+                }
+            }
+        } catch (...) {
+            failed = true;
+        }
+        if (failed) finish(*job, Status::FAILED);
+        lock_guard<mutex> guard(lock);
+        active.erase(job->ticket);
+        co_return vector<RubiksCube::MOVE>();
+    }
+
+    // Time out requests whose deadline passed before their search began.
+    // Searches stop at their deadline through the search limit and report
+    // themselves; one waiting for its next slice is moved to the front of
+    // the queue to do so promptly.
+    void timerLoop() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            auto now = Clock::now();
+            auto next = Clock::time_point::max();
+            vector<shared_ptr<Job>> expired;
+            for (auto &[ticket, job] : active) {
+                if (job->finished || job->expedited) continue;
+                if (job->limit.getDeadline() > now) {
+                    next = min(next, job->limit.getDeadline());
+                    continue;
+                }
+                job->expedited = true;
+                scheduler->setPriority(job->task, 1);
+                if (!job->started) expired.push_back(job);
+            }
+
+            uint64_t seen = submissions;
+            guard.unlock();
+            for (auto &job : expired) finish(*job, Status::TIMEOUT);
+            guard.lock();
+
+            auto woken = [&] { return stopping || submissions != seen; };
+            if (next == Clock::time_point::max()) {
+                deadlineChanged.wait(guard, woken);
+            } else {
+                deadlineChanged.wait_until(guard, next, woken);
+            }
+        }
+    }
+
+public:
+    // Nodes a solve searches before letting the next one have its turn
+    static const uint32_t SLICE_NODES = 4096;
+
+    // Databases must outlive the service; endgame, cache and the
+    // transposition table, shared by all workers, are optional.
+    // pinWorkers: spread the workers over the NUMA nodes round-robin, each
+    // pinned to its node, so they read their node's database replicas.
+    SolveService(const CornerPatternDatabase &cornerDB, int numWorkers,
+                 const EndgameDatabase *endgameDB = nullptr, SolutionCache *solutionCache = nullptr,
+                 TranspositionTable *transpositionTable = nullptr, bool pinWorkers = false)
+        : heuristic(cornerDB), endgame(endgameDB), cache(solutionCache), table(transpositionTable) {
+        int numNodes = NumaTopology::get().getNumNodes();
+        scheduler = make_unique<SolveScheduler>(numWorkers, [pinWorkers, numNodes](int i) {
+            if (pinWorkers) NumaTopology::get().pinThread(i % numNodes);
+        });
+        timer = thread([this] { timerLoop(); });
+    }
+
+    // Stops running solves; they and queued ones are reported cancelled
+    ~SolveService() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+            for (auto &[ticket, job] : active) job->limit.cancel();
+        }
+        deadlineChanged.notify_all();
+        timer.join();
+        // Running slices end at the cancellation; the other solves are dropped
+        scheduler.reset();
+        for (auto &[ticket, job] : active) finish(*job, Status::CANCELLED);
+    }
+
+    // Queue a cube; returns a ticket for cancel(). anytime: solve with
+    // IDAstarSolver::solveAnytime and report the best by the deadline.
+    uint64_t submit(const T &cube, Clock::time_point deadline, Callback done, bool anytime = false) {
+        uint64_t ticket;
+        {
+            lock_guard<mutex> guard(lock);
+            ticket = nextTicket++;
+            auto job = make_shared<Job>(ticket, cube, deadline, anytime, std::move(done));
+            active[ticket] = job;
+            job->task = scheduler->submit(run(job));
+            submissions++;
+        }
+        deadlineChanged.notify_one();
+        return ticket;
+    }
+
+    // Report a queued or running request as cancelled right away and stop
+    // its search. Returns false if it already finished.
+    bool cancel(uint64_t ticket) {
+        shared_ptr<Job> job;
+        {
+            lock_guard<mutex> guard(lock);
+            auto it = active.find(ticket);
+            if (it == active.end() || it->second->finished) return false;
+            job = it->second;
+            // Stop it at its next slice, which comes first
+            job->limit.cancel();
+            scheduler->setPriority(job->task, 1);
+        }
+        finish(*job, Status::CANCELLED);
+        return true;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SOLVESERVICE_H
@@ -0,0 +1,47 @@
+// Minimal client for rubiks_solverd: sends each line of stdin as a request
+// and prints replies as they arrive, until the server has answered all of
+// them.
+//
+// Usage: rubiks_solver_client <socket path> < requests.txt
+
+#include <bits/stdc++.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <socket path>\n";
+        return 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, argv[1], sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0) {
+        cerr << "cannot connect to " << argv[1] << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+
+    // Replies stream back independently of what is still being sent
+    thread reader([fd] {
+        char chunk[4096];
+        ssize_t n;
+        while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+            cout.write(chunk, n);
+            cout.flush();
+        }
+    });
+
+    string line;
+    while (getline(cin, line)) {
+        line += "\n";
+        if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) < 0) break;
+    }
+    // No more requests; the server closes once every reply is sent
+    shutdown(fd, SHUT_WR);
+    reader.join();
+    close(fd);
+    return 0;
+}
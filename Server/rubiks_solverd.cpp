@@ -0,0 +1,268 @@
+// Long-running solve server. Loads the pattern databases once (a raw corner
+// database is memory-mapped, a block-compressed one decompressed on every
+// CPU) and answers requests over a Unix domain socket.
+//
+// Usage: rubiks_solverd <socket path> <corner db file>
+//                       [--workers N] [--endgame DEPTH] [--cache ENTRIES]
+//                       [--table MB] [--numa interleave|replicate]
+//
+// The workers take turns on every request in flight, a slice of search at
+// a time, so a hard scramble never holds up the easy ones behind it.
+// --numa lays the corner database out over NUMA nodes: interleaved pages,
+// or a copy per node read by workers pinned to that node.
+//
+// Protocol: newline-delimited text, any number of requests per connection.
+//   solve <id> <timeout ms> facelets <54 color letters>
+//   solve <id> <timeout ms> moves <move> <move> ...
+//   anytime <id> <timeout ms> facelets|moves ...
+//   cancel <id>
+// A timeout of 0 means none. anytime requests return the shortest solution
+// found by the deadline rather than timing out. Facelets follow FaceletCube::toString(); moves
+// are scrambles applied to a solved cube, written like RubiksCube::getMove().
+// Each request gets exactly one reply line, sent as soon as it is known:
+//   <id> solved <move> <move> ...      (optimal)
+//   <id> best <move> <move> ...        (anytime, stopped at the deadline)
+//   <id> timeout
+//   <id> cancelled
+//   <id> error <reason>                (bad request, or the solve failed)
+
+#include <bits/stdc++.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../Model/RubiksCube3dArray.cpp"
+#include "../Model/FaceletCube.h"
+#include "../Model/CubieCube.h"
+#include "SolveService.h"
+using namespace std;
+
+typedef SolveService<RubiksCube3dArray, Hash3d> Service;
+
+namespace {
+    // One client connection, kept alive by its reader and pending replies.
+    // The socket closes once the client stopped sending and every reply
+    // went out.
+    struct Connection {
+        int fd;
+        mutex writeLock;                          // one reply line at a time
+        mutex lock;                               // guards tickets
+        unordered_map<string, uint64_t> tickets;  // request id -> service ticket
+
+        explicit Connection(int f) : fd(f) {}
+        ~Connection() { close(fd); }
+
+        void send(const string &line) {
+            lock_guard<mutex> guard(writeLock);
+            string out = line + "\n";
+            size_t sent = 0;
+            while (sent < out.size()) {
+                ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) return;     // client gone; drop the reply
+                sent += n;
+            }
+        }
+    };
+
+    const char* getStatusName(Service::Status status) {
+        switch (status) {
+            case Service::Status::SOLVED:    return "solved";
+            case Service::Status::BEST:      return "best";
+            case Service::Status::TIMEOUT:   return "timeout";
+            case Service::Status::CANCELLED: return "cancelled";
+            case Service::Status::FAILED:    return "error solve failed";
+        }
+        return "";
+    }
+
+    // Parse the cube part of a solve request into cube; returns an error
+    // message, empty on success
+    string parseCube(istringstream &in, RubiksCube3dArray &cube) {
+        string kind;
+        in >> kind;
+        if (kind == "moves") {
+            string token;
+            while (in >> token) {
+                RubiksCube::MOVE m;
+                if (!RubiksCube::parseMove(token, m)) return "bad move " + token;
+                cube.move(m);
+            }
+            return "";
+        }
+        if (kind == "facelets") {
+            string str;
+            in >> str;
+            FaceletCube facelets;
+            if (!FaceletCube::fromString(str, facelets)) return "malformed facelets";
+            if (!facelets.isValid()) return "invalid cubies";
+            for (int f = 0; f < 54; f++) {
+                cube.cube[f / 9][f / 3 % 3][f % 3] =
+                    RubiksCube::getColorLetter(RubiksCube::COLOR(facelets.facelets[f]));
+            }
+            if (!CubieCube::fromCube(cube).isSolvable()) return "unsolvable cube";
+            return "";
+        }
+        return "expected facelets or moves";
+    }
+
+    void handleLine(const string &line, const shared_ptr<Connection> &conn, Service &service) {
+        istringstream in(line);
+        string command, id;
+        in >> command >> id;
+        if (command.empty()) return;
+        if (id.empty()) {
+            conn->send("- error missing id");
+            return;
+        }
+
+        if (command == "cancel") {
+            uint64_t ticket = 0;
+            {
+                lock_guard<mutex> guard(conn->lock);
+                auto it = conn->tickets.find(id);
+                if (it != conn->tickets.end()) ticket = it->second;
+            }
+            if (!ticket || !service.cancel(ticket)) conn->send(id + " error not running");
+            return;
+        }
+        if (command != "solve" && command != "anytime") {
+            conn->send(id + " error unknown command " + command);
+            return;
+        }
+
+        long timeoutMs;
+        if (!(in >> timeoutMs) || timeoutMs < 0) {
+            conn->send(id + " error bad timeout");
+            return;
+        }
+        RubiksCube3dArray cube;
+        string error = parseCube(in, cube);
+        if (!error.empty()) {
+            conn->send(id + " error " + error);
+            return;
+        }
+
+        auto deadline = timeoutMs ? Service::Clock::now() + chrono::milliseconds(timeoutMs)
+                                  : Service::Clock::time_point::max();
+        // Hold the connection lock so a fast reply can't run before the
+        // ticket is recorded
+        unique_lock<mutex> guard(conn->lock);
+        if (conn->tickets.count(id)) {
+            guard.unlock();
+            conn->send(id + " error duplicate id");
+            return;
+        }
+        conn->tickets[id] = service.submit(cube, deadline,
+            [conn, id](Service::Status status, const vector<RubiksCube::MOVE> &moves) {
+                string reply = id + " " + getStatusName(status);
+                for (auto m : moves) reply += " " + RubiksCube::getMove(m);
+                {
+                    lock_guard<mutex> guard(conn->lock);
+                    conn->tickets.erase(id);
+                }
+                conn->send(reply);
+            }, command == "anytime");
+    }
+
+    void serveConnection(shared_ptr<Connection> conn, Service &service) {
+        string buffer;
+        char chunk[4096];
+        while (true) {
+            ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) break;
+            buffer.append(chunk, n);
+            size_t start = 0, end;
+            while ((end = buffer.find('\n', start)) != string::npos) {
+                handleLine(buffer.substr(start, end - start), conn, service);
+                start = end + 1;
+            }
+            buffer.erase(0, start);
+        }
+        if (!buffer.empty()) handleLine(buffer, conn, service);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <socket path> <corner db file>"
+             << " [--workers N] [--endgame DEPTH] [--cache ENTRIES] [--table MB]"
+             << " [--numa interleave|replicate]\n";
+        return 1;
+    }
+    string socketPath = argv[1], dbFile = argv[2];
+    int workers = max(1u, thread::hardware_concurrency());
+    int endgameDepth = 0;
+    size_t cacheSize = 0;
+    size_t tableMB = 0;
+    NumaPolicy numa = NumaPolicy::LOCAL;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--workers") workers = stoi(argv[i + 1]);
+        else if (flag == "--endgame") endgameDepth = stoi(argv[i + 1]);
+        else if (flag == "--cache") cacheSize = stoul(argv[i + 1]);
+        else if (flag == "--table") tableMB = stoul(argv[i + 1]);
+        else if (flag == "--numa") {
+            string policy = argv[i + 1];
+            if (policy == "interleave") numa = NumaPolicy::INTERLEAVE;
+            else if (policy == "replicate") numa = NumaPolicy::REPLICATE;
+            else {
+                cerr << "unknown NUMA policy " << policy << "\n";
+                return 1;
+            }
+        }
+        else {
+            cerr << "unknown option " << flag << "\n";
+            return 1;
+        }
+    }
+
+    CornerPatternDatabase cornerDB;
+    try {
+        if (!cornerDB.mapFile(dbFile)) {
+            cerr << "cannot map " << dbFile << "\n";
+            return 1;
+        }
+    } catch (const char *e) {
+        cerr << e << "\n";
+        return 1;
+    }
+    if (!cornerDB.place(numa)) {
+        cerr << "cannot place " << dbFile << " on NUMA nodes\n";
+        return 1;
+    }
+    unique_ptr<EndgameDatabase> endgame;
+    if (endgameDepth > 0) endgame = make_unique<EndgameDatabase>(endgameDepth);
+    unique_ptr<SolutionCache> cache;
+    if (cacheSize > 0) cache = make_unique<SolutionCache>(cacheSize);
+    unique_ptr<TranspositionTable> table;
+    if (tableMB > 0) table = make_unique<TranspositionTable>(tableMB);
+    Service service(cornerDB, workers, endgame.get(), cache.get(), table.get(),
+                    numa == NumaPolicy::REPLICATE);
+
+    signal(SIGPIPE, SIG_IGN);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        cerr << "socket path too long\n";
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (listener < 0 || ::bind(listener, (sockaddr*) &addr, sizeof(addr)) != 0 || listen(listener, 64) != 0) {
+        cerr << "cannot listen on " << socketPath << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    cerr << "rubiks_solverd: listening on " << socketPath << " with " << workers << " workers\n";
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        thread(serveConnection, make_shared<Connection>(fd), ref(service)).detach();
+    }
+    close(listener);
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <bits/stdc++.h>
 #include "../Model/RubiksCube.h"
+#include "SearchLimit.h"
 
 // BFS solver for a Rubik's Cube model T with hash H.
 // T must support move(), invert(), isSolved(), and operator==.
@@ -14,6 +15,9 @@ private:
     vector<RubiksCube::MOVE> moves;
     unordered_map<T, bool, H> visited;
     unordered_map<T, RubiksCube::MOVE, H> move_done;
+    const SearchLimit *searchLimit = nullptr;
+    uint32_t pollCounter = 0;
+    bool stopped = false;
 
     // Run breadth-first search from rubiksCube, return solved state.
     T bfs() {
@@ -24,6 +28,10 @@ private:
         while (!q.empty()) {
             T node = q.front(); 
             q.pop();
+            if (SearchLimit::poll(searchLimit, pollCounter)) {
+                stopped = true;
+                break;
+            }
             if (node.isSolved()) {
                 return node;
             }
@@ -46,9 +54,21 @@ public:
 
     BFSSolver(T _rubiksCube) : rubiksCube(_rubiksCube) {}
 
+    // Stop searching once limit is reached; it must outlive the solver
+    void setSearchLimit(const SearchLimit *limit) {
+        searchLimit = limit;
+    }
+
+    // Whether the last solve was cut short by the search limit
+    bool isStopped() const {
+        return stopped;
+    }
+
     // Perform BFS and reconstruct the move sequence to solve the cube.
+    // Returns no moves if the search limit stops it first.
     vector<RubiksCube::MOVE> solve() {
         T solved_cube = bfs();
+        if (stopped) return {};
         assert(solved_cube.isSolved());
         T curr_cube = solved_cube;
         while (!(curr_cube == rubiksCube)) {
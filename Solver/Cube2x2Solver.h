@@ -0,0 +1,80 @@
+#ifndef RUBIKS_CUBE_SOLVER_CUBE2X2SOLVER_H
+#define RUBIKS_CUBE_SOLVER_CUBE2X2SOLVER_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube2x2.h"
+#include "../PatternDatabases/Cube2x2Database.h"
+#include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/CornerMoveTables.h"
+
+// Optimal 2x2x2 solver with no search. Given exact distances for every
+// state, it takes at each step any move to a state one move closer, so a
+// solve is at most 11 steps of a few table lookups. The distances come
+// from a Cube2x2Database, or from a CornerPatternDatabase generated to the
+// end (CornerDBMaker::bfsAndStore(11)): the 3x3 corners with the centers
+// as a fixed frame, so there the walk starts from whichever of the 24
+// rotations of the cube is closest to solved.
+class Cube2x2Solver {
+    const Cube2x2Database *compactDB = nullptr;
+    const CornerPatternDatabase *cornerDB = nullptr;
+
+    vector<RubiksCube::MOVE> solveCompact(const RubiksCube2x2 &cube) const {
+        vector<RubiksCube::MOVE> solution;
+        uint32_t index = compactDB->getIndex(cube.corners);
+        for (uint8_t dist = compactDB->getDistance(index); dist > 0; dist--) {
+            for (int m = 0; m < Cube2x2Database::NUM_MOVES; m++) {
+                uint32_t next = compactDB->move(index, m);
+                if (compactDB->getDistance(next) == dist - 1) {
+                    solution.push_back(Cube2x2Database::moves[m]);
+                    index = next;
+                    break;
+                }
+            }
+        }
+        return solution;
+    }
+
+    vector<RubiksCube::MOVE> solveCorner(const RubiksCube2x2 &cube) const {
+        const CornerMoveTables &tables = CornerMoveTables::getInstance();
+        CornerCoordinate coord{};
+        uint8_t dist = 0xFF;
+        for (const CornerCubies &rotation : RubiksCube2x2::getRotations()) {
+            CornerCoordinate start = tables.getCoordinate(CornerCubies::multiply(rotation.inverse(), cube.corners));
+            uint8_t startDist = cornerDB->getNumMoves(start.getDatabaseIndex());
+            if (startDist < dist) {
+                coord = start;
+                dist = startDist;
+            }
+        }
+
+        vector<RubiksCube::MOVE> solution;
+        for (; dist > 0; dist--) {
+            bool found = false;
+            for (int m = 0; m < 18 && !found; m++) {
+                CornerCoordinate next = tables.move(coord, RubiksCube::MOVE(m));
+                if (cornerDB->getNumMoves(next.getDatabaseIndex()) == dist - 1) {
+                    solution.push_back(RubiksCube::MOVE(m));
+                    coord = next;
+                    found = true;
+                }
+            }
+            if (!found) throw "Corner database is not fully generated";
+        }
+        return solution;
+    }
+
+public:
+    explicit Cube2x2Solver(const Cube2x2Database &db) : compactDB(&db) {}
+
+    // db must hold every distance; the walk throws where it finds one
+    // missing
+    explicit Cube2x2Solver(const CornerPatternDatabase &db) : cornerDB(&db) {}
+
+    // Optimal face-turn solution, ending with the cube solved in whatever
+    // orientation is closest
+    vector<RubiksCube::MOVE> solve(const RubiksCube2x2 &cube) const {
+        return compactDB ? solveCompact(cube) : solveCorner(cube);
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_CUBE2X2SOLVER_H
@@ -1,6 +1,10 @@
 
 #include<bits/stdc++.h>
 #include "../Model/RubiksCube.h"
+#include "../PatternDatabases/EndgameDatabase.h"
+#include "SearchLimit.h"
+#include "SearchStack.h"
+#include "MoveOrdering.h"
 
 #ifndef RUBIKS_CUBE_SOLVER_DFSSOLVER_H
 #define RUBIKS_CUBE_SOLVER_DFSSOLVER_H
@@ -11,19 +15,89 @@
 template<typename T, typename H>
 class DFSSolver {
 private:
+    // Per-ply data kept on the search stack
+    struct Frame {
+        CubieCube cubies;           // cubie copy of the node, with endgame only
+        int distance;               // its endgame distance, with endgame only
+        CubieCube childCubies[18];
+        int scores[18];             // children's endgame distances, with endgame only
+        uint8_t order[18];          // canonical moves, best first
+    };
 
     vector<RubiksCube::MOVE> moves;
     int max_search_depth;
+    const EndgameDatabase *endgame;
+    SearchStack<Frame> *stack = nullptr;    // this thread's, during solve()
+    MoveOrdering ordering;                  // with endgame only; kept across solves to growing depths
+    const SearchLimit *searchLimit = nullptr;
+    uint32_t pollCounter = 0;
+    bool stopped = false;
+
+//    Finish from a state the endgame database knows, if the moves left allow it.
+//    Returns 1 if solved, 0 if this branch cannot succeed, -1 to keep searching.
+    int probeEndgame(int dep) {
+        const Frame &node = (*stack)[dep - 1];
+        int remaining = max_search_depth - dep + 1;
+        // Unstored states are further than the table reaches
+        if (node.distance > endgame->getMaxDepth()) {
+            return node.distance > remaining ? 0 : -1;
+        }
+        if (node.distance > remaining) return 0;
+        moves = stack->getPath();
+        for (auto m : endgame->getSolution(node.cubies)) {
+            rubiksCube.move(m);
+            moves.push_back(m);
+        }
+        return 1;
+    }
 
 //    DFS code to find the solution (helper function)
     bool dfs(int dep) {
-        if (rubiksCube.isSolved()) return true;
-        if (dep > max_search_depth) return false;
-        for (int i = 0; i < 18; i++) {
+        if (stopped || SearchLimit::poll(searchLimit, pollCounter)) {
+            stopped = true;
+            return false;
+        }
+        if (endgame) {
+            int probe = probeEndgame(dep);
+            if (probe >= 0) return probe;
+        }
+        if (rubiksCube.isSolved()) {
+            moves = stack->getPath();
+            return true;
+        }
+        if (dep > max_search_depth || stack->full()) return false;
+        Frame &node = (*stack)[dep - 1];
+        int last = stack->last();
+        // With an endgame table, children nearer the goal by it go first,
+        // then by the move order learned so far. Without one there is
+        // nothing to order by: the canonical moves go in MOVE order.
+        int count = 0;
+        if (endgame) {
+            for (int i = 0; i < 18; i++) {
+                node.scores[i] = 0;
+                if (!isCanonicalMove(last, i)) continue;
+                node.childCubies[i] = node.cubies;
+                node.childCubies[i].move(RubiksCube::MOVE(i));
+                node.scores[i] = endgame->getDistance(node.childCubies[i]);
+            }
+            ordering.visit(*stack, node.distance);
+            count = ordering.sort(dep - 1, last, node.scores, node.order);
+        } else {
+            for (int i = 0; i < 18; i++)
+                if (isCanonicalMove(last, i)) node.order[count++] = i;
+        }
+        for (int k = 0; k < count; k++) {
+            int i = node.order[k];
             rubiksCube.move(RubiksCube::MOVE(i));
-            moves.push_back(RubiksCube::MOVE(i));
+            stack->push(RubiksCube::MOVE(i));
+            if (endgame) {
+                Frame &child = (*stack)[dep];
+                child.cubies = node.childCubies[i];
+                child.distance = node.scores[i];
+                if (child.distance < node.distance) ordering.reward(dep - 1, i);
+            }
             if (dfs(dep + 1)) return true;
-            moves.pop_back();
+            stack->pop();
             rubiksCube.invert(RubiksCube::MOVE(i));
         }
         return false;
@@ -32,12 +106,44 @@ private:
 public:
     T rubiksCube;
 
-    DFSSolver(T _rubiksCube, int _max_search_depth = 8) {
+    // _endgame: optional table of near-solved states; the search stops as
+    // soon as it reaches one within the remaining depth. Children are
+    // ordered (see MoveOrdering) only with a table, by their distance in
+    // it; without one they are tried in MOVE order.
+    DFSSolver(T _rubiksCube, int _max_search_depth = 8, const EndgameDatabase *_endgame = nullptr) {
         rubiksCube = _rubiksCube;
         max_search_depth = _max_search_depth;
+        endgame = _endgame;
+    }
+
+    // Stop searching once limit is reached; it must outlive the solver
+    void setSearchLimit(const SearchLimit *limit) {
+        searchLimit = limit;
+    }
+
+    // Whether the last solve was cut short by the search limit; the cube
+    // is then left unchanged and no moves are returned
+    bool isStopped() const {
+        return stopped;
     }
 
     vector<RubiksCube::MOVE> solve() {
+        return solve(max_search_depth);
+    }
+
+    // Search to the given depth instead; an unsolved search leaves the
+    // cube as it was, so the same solver can try again deeper, starting
+    // with the move order it learned (with an endgame table)
+    vector<RubiksCube::MOVE> solve(int depth) {
+        max_search_depth = depth;
+        stopped = false;
+        moves.clear();
+        stack = &SearchStack<Frame>::forThread();
+        stack->clear();
+        if (endgame) {
+            (*stack)[0].cubies = CubieCube::fromCube(rubiksCube);
+            (*stack)[0].distance = endgame->getDistance((*stack)[0].cubies);
+        }
         dfs(1);
         return moves;
     }
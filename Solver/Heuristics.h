@@ -0,0 +1,173 @@
+#ifndef RUBIKS_CUBE_SOLVER_HEURISTICS_H
+#define RUBIKS_CUBE_SOLVER_HEURISTICS_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../Model/CubieCube.h"
+#include "../PatternDatabases/PatternDatabase.h"
+#include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/CornerMoveTables.h"
+
+// Heuristics pluggable into IDAstarSolver. Each one provides:
+//   State                          per-node data the search carries along
+//   getState(cube)                 State of a starting cube
+//   move(state, m)                 State of the child reached by move m
+//   prefetch(state)                start loading what estimate() will read
+//   estimate(state, cube)          lower bound on moves left for cube
+//   consistent                     whether estimates drop by at most one
+//                                  per move; the solver applies BPMX if not
+// Heuristics only hold references to their databases, so they are cheap
+// to copy and one loaded database can serve many solvers.
+
+// Corner pattern database, indexed incrementally through CornerMoveTables.
+class CornerHeuristic {
+    const CornerPatternDatabase *db;
+    const CornerMoveTables *tables;
+
+public:
+    typedef CornerCoordinate State;
+    static constexpr bool consistent = true;
+
+    CornerHeuristic(const CornerPatternDatabase &cornerDB)
+        : db(&cornerDB), tables(&CornerMoveTables::getInstance()) {}
+
+    State getState(const RubiksCube &cube) const {
+        return tables->getCoordinate(cube);
+    }
+
+    State move(const State &state, RubiksCube::MOVE m) const {
+        return tables->move(state, m);
+    }
+
+    void prefetch(const State &state) const {
+        db->prefetch(db->getDatabaseIndex(state));
+    }
+
+    uint8_t estimate(const State &state, const RubiksCube &) const {
+        return db->getNumMoves(db->getDatabaseIndex(state));
+    }
+};
+
+// Edges out of place or flipped, four per move: no move touches more than
+// four edges, so this is admissible and consistent. Weak on its own, but
+// combined with the corner database (MaxHeuristic) it keeps weighted
+// searches from drifting once the corners are solved.
+class EdgeCountHeuristic {
+public:
+    typedef EdgeCubies State;
+    static constexpr bool consistent = true;
+
+    State getState(const RubiksCube &cube) const {
+        return EdgeCubies::fromCube(cube);
+    }
+
+    State move(const State &state, RubiksCube::MOVE m) const {
+        State next = state;
+        next.move(m);
+        return next;
+    }
+
+    void prefetch(const State &) const {}
+
+    uint8_t estimate(const State &state, const RubiksCube &) const {
+        int wrong = 0;
+        for (int i = 0; i < 12; i++) wrong += state.ep[i] != i || state.eo[i];
+        return (wrong + 3) / 4;
+    }
+};
+
+// Any pattern database, indexed from the cube at every node.
+class PatternDatabaseHeuristic {
+    const PatternDatabase *db;
+
+public:
+    struct State {};
+    static constexpr bool consistent = true;
+
+    PatternDatabaseHeuristic(const PatternDatabase &database) : db(&database) {}
+
+    State getState(const RubiksCube &) const { return {}; }
+    State move(const State &, RubiksCube::MOVE) const { return {}; }
+    void prefetch(const State &) const {}
+
+    uint8_t estimate(const State &, const RubiksCube &cube) const {
+        return db->getNumMoves(cube);
+    }
+};
+
+// Shared plumbing for heuristics built from several others
+template<typename... Hs>
+class CompositeHeuristic {
+protected:
+    tuple<Hs...> parts;
+
+    template<typename F>
+    void forEach(F f) const {
+        forEachPart(f, index_sequence_for<Hs...>{});
+    }
+
+    template<typename F, size_t... I>
+    void forEachPart(F f, index_sequence<I...>) const {
+        (f(get<I>(parts), integral_constant<size_t, I>{}), ...);
+    }
+
+public:
+    typedef tuple<typename Hs::State...> State;
+    static constexpr bool consistent = (Hs::consistent && ...);
+
+    CompositeHeuristic(Hs... hs) : parts(hs...) {}
+
+    State getState(const RubiksCube &cube) const {
+        return apply([&](const Hs&... h) { return State(h.getState(cube)...); }, parts);
+    }
+
+    State move(const State &state, RubiksCube::MOVE m) const {
+        State next;
+        forEach([&](const auto &h, auto i) {
+            get<decltype(i)::value>(next) = h.move(get<decltype(i)::value>(state), m);
+        });
+        return next;
+    }
+
+    void prefetch(const State &state) const {
+        forEach([&](const auto &h, auto i) { h.prefetch(get<decltype(i)::value>(state)); });
+    }
+};
+
+// Largest estimate of any part. Admissible whenever every part is.
+template<typename... Hs>
+class MaxHeuristic : public CompositeHeuristic<Hs...> {
+public:
+    typedef typename CompositeHeuristic<Hs...>::State State;
+
+    MaxHeuristic(Hs... hs) : CompositeHeuristic<Hs...>(hs...) {}
+
+    uint8_t estimate(const State &state, const RubiksCube &cube) const {
+        uint8_t best = 0;
+        this->forEach([&](const auto &h, auto i) {
+            best = max(best, h.estimate(get<decltype(i)::value>(state), cube));
+        });
+        return best;
+    }
+};
+
+// Sum of the parts' estimates. Only admissible when the databases are
+// disjoint: each tracks its own cubies and counts only the moves that
+// touch them, so no move is charged twice.
+template<typename... Hs>
+class AdditiveHeuristic : public CompositeHeuristic<Hs...> {
+public:
+    typedef typename CompositeHeuristic<Hs...>::State State;
+
+    AdditiveHeuristic(Hs... hs) : CompositeHeuristic<Hs...>(hs...) {}
+
+    uint8_t estimate(const State &state, const RubiksCube &cube) const {
+        int sum = 0;
+        this->forEach([&](const auto &h, auto i) {
+            sum += h.estimate(get<decltype(i)::value>(state), cube);
+        });
+        return sum;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_HEURISTICS_H
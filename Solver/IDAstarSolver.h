@@ -4,119 +4,482 @@
 #include <bits/stdc++.h>
 #include "../Model/RubiksCube.h"
 #include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/CornerMoveTables.h"
+#include "../PatternDatabases/EndgameDatabase.h"
+#include "Heuristics.h"
+#include "SearchLimit.h"
+#include "SearchStats.h"
+#include "SearchStack.h"
+#include "MoveOrdering.h"
+#include "TranspositionTable.h"
+#include "SolveTask.h"
 
-// IDA* solver using a corner-pattern database heuristic.
+// IDA* solver guided by a pattern-database heuristic: depth-first passes
+// with a growing bound on f = depth + estimate, over canonical move
+// sequences, with per-ply data on the thread's SearchStack. Children are
+// tried in MoveOrdering order, learned over the earlier passes. The passes
+// walk the stack in a loop rather than recursing, so a solve can also run
+// as a SolveTask, pausing every so many nodes.
 // T: cube representation (3D, 1D, or bitboard).
 // H: hash functor for T.
+// Heuristic: see Heuristics.h; defaults to the corner pattern database.
 
-template<typename T, typename H>
+template<typename T, typename H, typename Heuristic = CornerHeuristic>
 class IDAstarSolver {
 private:
-    CornerPatternDatabase cornerDB;                    // heuristic data
+    typedef typename Heuristic::State HState;
+
+    // Per-ply data kept on the search stack
+    struct Frame {
+        HState hstate;              // heuristic data carried along with the cube
+        CubieCube cubies;           // kept only with an endgame DB or table
+        CubeKey key;                // transposition table key, with a table only
+        int estimate;               // heuristic estimate to goal
+        double nextBound;           // smallest f cut off in the subtree so far
+        bool useTable;              // consults and updates the table
+        uint64_t truncationsBefore; // truncations on entering
+        HState childStates[18];     // children's data, filled on expansion
+        CubieCube childCubies[18];
+        int hs[18];
+        uint8_t order[18];          // canonical moves, best first
+        int count;                  // how many of them
+        int next;                   // next of them to try
+    };
+
+    unique_ptr<CornerPatternDatabase> cornerDB;        // owned DB, file constructor only
+    Heuristic heuristic;                               // heuristic data
     vector<RubiksCube::MOVE> moves;                    // solution moves
-    unordered_map<T, RubiksCube::MOVE, H> move_done;   // backpointers
-    unordered_map<T, bool, H> visited;                 // visited states
+    T cube;                                            // node being searched
+    SearchStack<Frame> *stack = nullptr;               // this thread's, or ownStack
+    unique_ptr<SearchStack<Frame>> ownStack;           // for searches run in slices
+    MoveOrdering ordering;                             // kept across iterations
+    bool twoPassExpansion;                             // prefetch children's DB entries
+    const EndgameDatabase *endgame = nullptr;          // optional near-solved table
+    TranspositionTable *table = nullptr;               // optional shared distance bounds
+    int tableMinDepth = 0;                             // moves left to use the table
+    uint64_t truncations = 0;                          // nodes cut by the stack depth
+    vector<RubiksCube::MOVE> endgameMoves;             // tail of the solution from endgame
+    const SearchLimit *searchLimit = nullptr;          // optional deadline/cancellation
+    uint32_t pollCounter = 0;
+    bool stopped = false;                              // last solve hit the limit
 
-    struct Node {
-        T cube;
-        int depth;       // current search depth
-        int estimate;    // heuristic estimate to goal
+    SearchStats stats;                                 // of the last solve
 
-        Node(T c, int d, int e) : cube(c), depth(d), estimate(e) {}
-    };
+    // Current pass: f = depth + weight * estimate, each iteration also
+    // accepts solutions up to slack moves over its bound, and no solution
+    // longer than maxLength is wanted
+    double weight = 1.0;
+    int slack = 0;
+    int maxLength = INT_MAX;
 
-    struct Compare {
-        bool operator()(const pair<Node, int>& a, const pair<Node, int>& b) {
-            int f1 = a.first.depth + a.first.estimate;
-            int f2 = b.first.depth + b.first.estimate;
-            if (f1 == f2) {
-                return a.first.estimate > b.first.estimate;
-            }
-            return f1 > f2;
-        }
-    };
+    // Where the search is, for resuming it
+    double bound = 0;                                  // of the current pass
+    bool passRunning = false;
+    int depth = -1;                                    // deepest expanded ply; -1 before the root
+    uint64_t passStartExpanded = 0;
 
-    void resetSearch() {
-        moves.clear();
-        move_done.clear();
-        visited.clear();
+    static unique_ptr<CornerPatternDatabase> loadCornerDB(const string& dbFile) {
+        auto db = make_unique<CornerPatternDatabase>();
+        db->loadFileAsync(dbFile);
+        return db;
     }
 
-    // Perform one iteration of IDA* with bound 'limit'.
-    // Returns: {solved_cube, next_bound_if_not_solved}.
-    pair<T,int> search(int limit) {
-        priority_queue<pair<Node,int>, vector<pair<Node,int>>, Compare> pq;
-        Node start{ rubiksCube, 0, cornerDB.getNumMoves(rubiksCube) };
-        pq.push({ start, 0 });
-        int nextBound = INT_MAX;
+    // Result of entering a node: the search reached a goal, the node is
+    // done (cut off, or stopped by the limit), or its children are ready
+    enum class Visit { FOUND, LEAF, EXPANDED };
 
-        while (!pq.empty()) {
-            auto [node, lastMove] = pq.top();
-            pq.pop();
+    // Result of running the search for a while
+    enum class Progress { FOUND, DONE, PAUSED };
 
-            // Skip if we've already visited this state
-            if (visited[node.cube]) continue;
-            visited[node.cube] = true;
-            move_done[node.cube] = static_cast<RubiksCube::MOVE>(lastMove);
+    // Enter the node at ply, whose frame is filled in and which cube holds,
+    // in the pass with the given bound. Returns FOUND once cube is solved,
+    // or stored in the endgame DB (then solved by endgameMoves). Otherwise
+    // the frame's nextBound starts collecting the smallest f over the
+    // bound within maxLength in the node's subtree.
+    Visit enter(int ply, double limit) {
+        Frame &node = (*stack)[ply];
+        node.nextBound = numeric_limits<double>::infinity();
+        if (SearchLimit::poll(searchLimit, pollCounter)) {
+            stopped = true;
+            return Visit::LEAF;
+        }
+        stats.nodesExpanded++;
+        ordering.visit(*stack, node.estimate);
 
-            if (node.cube.isSolved()) {
-                return { node.cube, limit };
+        if (cube.isSolved()) return Visit::FOUND;
+        // Stored states are within the bound: their distance is part of
+        // the estimate that let them in
+        if (endgame) {
+            uint8_t distance;
+            RubiksCube::MOVE next;
+            if (endgame->lookup(node.cubies, distance, next)) {
+                endgameMoves = endgame->getSolution(node.cubies);
+                return Visit::FOUND;
             }
+        }
+        // A bound proven by an earlier pass, or reached by another path
+        node.useTable = table && (limit - ply) / weight >= tableMinDepth;
+        if (node.useTable) {
+            node.key = TranspositionTable::getSearchKey(
+                (endgame ? node.cubies : CubieCube::fromCube(cube)).getKey(), stack->last());
+            int bound = table->getBound(node.key);
+            if (bound > node.estimate) {
+                node.estimate = bound;
+                double f = ply + weight * bound;
+                if (f > limit) {
+                    stats.tableCutoffs++;
+                    if (ply + bound <= maxLength) node.nextBound = f;
+                    return Visit::LEAF;
+                }
+            }
+        }
+        if (stack->full()) {
+            truncations++;
+            return Visit::LEAF;
+        }
+        node.truncationsBefore = truncations;
 
-            int newDepth = node.depth + 1;
+        int last = stack->last();
+
+        // Incremental heuristic data for every child
+        for (int i = 0; i < 18; ++i) {
+            if (!isCanonicalMove(last, i)) continue;
+            node.childStates[i] = heuristic.move(node.hstate, static_cast<RubiksCube::MOVE>(i));
+            if (usesCubies()) {
+                node.childCubies[i] = node.cubies;
+                node.childCubies[i].move(static_cast<RubiksCube::MOVE>(i));
+            }
+        }
+        // First pass: start every child's DB fetch so the misses overlap
+        // with each other
+        if (twoPassExpansion) {
             for (int i = 0; i < 18; ++i) {
-                RubiksCube::MOVE m = static_cast<RubiksCube::MOVE>(i);
-                node.cube.move(m);
-                if (!visited[node.cube]) {
-                    int h = cornerDB.getNumMoves(node.cube);
-                    int f = newDepth + h;
-                    if (f > limit) {
-                        nextBound = min(nextBound, f);
-                    } else {
-                        Node child{ node.cube, newDepth, h };
-                        pq.push({ child, i });
-                    }
-                }
-                node.cube.invert(m);
+                if (isCanonicalMove(last, i)) heuristic.prefetch(node.childStates[i]);
+            }
+        }
+
+        // Second pass: evaluate the children
+        int best = 0;
+        for (int i = 0; i < 18; ++i) {
+            if (!isCanonicalMove(last, i)) continue;
+            RubiksCube::MOVE m = static_cast<RubiksCube::MOVE>(i);
+            cube.move(m);
+            stats.nodesGenerated++;
+            node.hs[i] = heuristic.estimate(node.childStates[i], cube);
+            if (endgame) node.hs[i] = max(node.hs[i], (int) endgame->getDistance(node.childCubies[i]));
+            best = max(best, node.hs[i]);
+            cube.invert(m);
+        }
+
+        // Bidirectional pathmax: a child's estimate less one also bounds
+        // this node, and this node's estimate less one bounds every child
+        if (!Heuristic::consistent && best - 1 > node.estimate) {
+            node.estimate = best - 1;
+            double f = ply + weight * node.estimate;
+            if (f > limit) {
+                if (ply + node.estimate <= maxLength) node.nextBound = f;
+                return Visit::LEAF;
+            }
+        }
+
+        node.count = ordering.sort(ply, last, node.hs, node.order);
+        node.next = 0;
+        return Visit::EXPANDED;
+    }
+
+    // Every path on from the expanded node at ply was cut at some f >=
+    // its nextBound, with an admissible estimate, or for passing
+    // maxLength: the distance from there is at least what is left.
+    // Weighted cuts prove nothing.
+    void leave(int ply, double limit) {
+        Frame &node = (*stack)[ply];
+        if (node.useTable && weight == 1.0 && truncations == node.truncationsBefore) {
+            double proven = min(node.nextBound, maxLength + 1.0) - ply;
+            table->store(node.key, (uint8_t) min(proven, 255.0), (uint8_t) max(limit - ply, 0.0));
+        }
+    }
+
+    // Run the current pass depth-first, with an explicit stack so it can
+    // pause between nodes and resume later, until it finds a solution
+    // (with the moves on the stack), ends (the root's nextBound holding
+    // the next bound) or the limit stops it, or until pauseAt nodes have
+    // been expanded
+    Progress runPass(uint64_t pauseAt) {
+        if (depth < 0) {
+            Visit v = enter(0, bound);
+            if (v != Visit::EXPANDED) return v == Visit::FOUND ? Progress::FOUND : Progress::DONE;
+            depth = 0;
+        }
+        while (!stopped) {
+            if (stats.nodesExpanded >= pauseAt) return Progress::PAUSED;
+            Frame &node = (*stack)[depth];
+            if (node.next == node.count) {
+                // Done with this node: back to its parent
+                leave(depth, bound);
+                if (depth == 0) return Progress::DONE;
+                Frame &parent = (*stack)[--depth];
+                parent.nextBound = min(parent.nextBound, node.nextBound);
+                stack->pop();
+                cube.invert(stack->getMove(depth));
+                continue;
+            }
+
+            int i = node.order[node.next++];
+            int newDepth = depth + 1;
+            int h = max(node.hs[i], node.estimate - 1);
+            // Estimates are lower bounds: nothing below fits in maxLength
+            if (newDepth + h > maxLength) continue;
+            double f = newDepth + weight * h;
+            if (f > bound) {
+                node.nextBound = min(node.nextBound, f);
+                continue;
+            }
+            if (node.hs[i] < node.estimate) ordering.reward(depth, i);
+            RubiksCube::MOVE m = static_cast<RubiksCube::MOVE>(i);
+            Frame &child = (*stack)[newDepth];
+            child.hstate = node.childStates[i];
+            if (usesCubies()) child.cubies = node.childCubies[i];
+            child.estimate = h;
+            cube.move(m);
+            stack->push(m);
+            Visit v = enter(newDepth, bound);
+            if (v == Visit::FOUND) return Progress::FOUND;
+            if (v == Visit::EXPANDED) {
+                depth = newDepth;
+                continue;
+            }
+            node.nextBound = min(node.nextBound, child.nextBound);
+            stack->pop();
+            cube.invert(m);
+        }
+        return Progress::DONE;
+    }
+
+    bool usesCubies() const {
+        return endgame;
+    }
+
+    int initialEstimate(const HState& state, const CubieCube& cubies) {
+        int h = heuristic.estimate(state, rubiksCube);
+        if (endgame) h = max(h, (int) endgame->getDistance(cubies));
+        return h;
+    }
+
+    // Set up a search with the current weight, slack and maxLength: the
+    // root, and the first bound. Returns false if the root's estimate
+    // already rules out anything within maxLength. stepped: the search
+    // will run in slices, interleaved with others on its thread, so it
+    // needs a stack of its own.
+    bool startSearch(bool stepped) {
+        if (stepped && !ownStack) ownStack = make_unique<SearchStack<Frame>>();
+        stack = stepped ? ownStack.get() : &SearchStack<Frame>::forThread();
+        Frame &root = (*stack)[0];
+        root.hstate = heuristic.getState(rubiksCube);
+        root.cubies = usesCubies() ? CubieCube::fromCube(rubiksCube) : CubieCube();
+        root.estimate = initialEstimate(root.hstate, root.cubies);
+        stats.weight = weight;
+        stats.slack = slack;
+        stats.lowerBound = max(stats.lowerBound, root.estimate);
+        bound = weight * root.estimate + slack;
+        passRunning = false;
+        return root.estimate <= maxLength;
+    }
+
+    // Run iterations with growing bounds until a solution turns up, the
+    // space within maxLength is exhausted, or the limit stops the search,
+    // pausing after about sliceNodes nodes (0: never). Returns FOUND once
+    // moves holds a solution; updates stats.
+    Progress continueSearch(uint64_t sliceNodes) {
+        auto startTime = chrono::steady_clock::now();
+        uint64_t pauseAt = sliceNodes ? stats.nodesExpanded + sliceNodes : UINT64_MAX;
+        Progress progress;
+        while (true) {
+            if (!passRunning) {
+                moves.clear();
+                endgameMoves.clear();
+                stack->clear();
+                cube = rubiksCube;
+                stats.iterations++;
+                passStartExpanded = stats.nodesExpanded;
+                depth = -1;
+                passRunning = true;
             }
+            progress = runPass(pauseAt);
+            if (progress == Progress::PAUSED) break;
+            passRunning = false;
+            stats.lastIterationExpanded = stats.nodesExpanded - passStartExpanded;
+            if (progress == Progress::FOUND) break;
+            double nextBound = (*stack)[0].nextBound;
+            if (stopped || nextBound == numeric_limits<double>::infinity()) break;
+            // An exhausted unweighted pass rules out everything below the
+            // smallest f it cut off
+            if (weight == 1.0) stats.lowerBound = max(stats.lowerBound, (int) nextBound);
+            bound = nextBound + slack;
+        }
+        stats.elapsedMs += chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+        if (progress != Progress::FOUND) return progress;
+
+        moves = stack->getPath();
+        moves.insert(moves.end(), endgameMoves.begin(), endgameMoves.end());
+        stats.solutionLength = moves.size();
+        // Plain IDA* with a consistent heuristic finds an optimal solution
+        if (weight == 1.0 && slack == 0 && Heuristic::consistent) {
+            stats.lowerBound = moves.size();
         }
-        return { rubiksCube, nextBound };
+        return progress;
+    }
+
+    void applySolution(const vector<RubiksCube::MOVE>& solution) {
+        for (auto m : solution) rubiksCube.move(m);
+        assert(rubiksCube.isSolved());
     }
 
 public:
     T rubiksCube;  // initial cube state
 
-    // Constructor: load a precomputed corner DB from file.
-    IDAstarSolver(T cube, const string& dbFile) {
+    // Constructor: load a precomputed corner DB from file, in the
+    // background; solving starts before it is complete.
+    // twoPass: prefetch all children's DB entries before evaluating them.
+    IDAstarSolver(T cube, const string& dbFile, bool twoPass = true)
+        requires is_same_v<Heuristic, CornerHeuristic>
+        : cornerDB(loadCornerDB(dbFile)), heuristic(*cornerDB), twoPassExpansion(twoPass) {
         rubiksCube = cube;
-        cornerDB.fromFile(dbFile);
     }
 
-    // Repeatedly increase bound until solved.
+    // Constructor: search with an already-built heuristic, whose databases
+    // must outlive the solver.
+    IDAstarSolver(T cube, Heuristic _heuristic, bool twoPass = true)
+        : heuristic(_heuristic), twoPassExpansion(twoPass) {
+        rubiksCube = cube;
+    }
+
+    // Consult a table of near-solved states: its exact distances tighten
+    // the estimate, and the search ends on reaching any stored state. The
+    // table must outlive the solver.
+    void setEndgameDatabase(const EndgameDatabase* db) {
+        endgame = db;
+    }
+
+    // Cut transpositions with distance bounds kept in table, which may be
+    // shared with other solvers and threads and must outlive the solver.
+    // Plain and k-bounded passes store bounds; weighted ones only read.
+    // Only nodes with at least minDepth moves left under the bound use it:
+    // canonical move sequences rarely transpose, so the table pays for its
+    // key computation mostly on large subtrees and on repeated searches
+    // (anytime passes, similar cubes).
+    void setTranspositionTable(TranspositionTable* tt, int minDepth = 6) {
+        table = tt;
+        tableMinDepth = minDepth;
+    }
+
+    // Stop searching once limit is reached; it must outlive the solver
+    void setSearchLimit(const SearchLimit* limit) {
+        searchLimit = limit;
+    }
+
+    // Whether the last solve was cut short by the search limit
+    bool isStopped() const {
+        return stopped;
+    }
+
+    // Counters and the achieved optimality bound of the last solve
+    const SearchStats& getStats() const {
+        return stats;
+    }
+
+    // Repeatedly increase bound until solved. If the search limit stops
+    // it first, returns an empty sequence and leaves rubiksCube as it was.
     vector<RubiksCube::MOVE> solve() {
-        int bound = cornerDB.getNumMoves(rubiksCube);
-        pair<T,int> result = search(bound);
+        return solveBounded(1.0, 0);
+    }
 
-        while (result.second != bound) {
-            resetSearch();
-            bound = result.second;
-            result = search(bound);
-        }
+    // Weighted search, f = g + w * h (w >= 1): much faster on deep
+    // scrambles, with solutions at most w times the optimal length.
+    vector<RubiksCube::MOVE> solveWeighted(double w) {
+        return solveBounded(max(w, 1.0), 0);
+    }
 
-        T solvedCube = result.first;
-        assert(solvedCube.isSolved());
+    // Solution at most k moves longer than optimal. Each iteration accepts
+    // anything up to k over its bound, so far fewer iterations are run.
+    vector<RubiksCube::MOVE> solveWithin(int k) {
+        return solveBounded(1.0, max(k, 0));
+    }
+
+    // Length at most w * optimal + k; the modes above are special cases
+    vector<RubiksCube::MOVE> solveBounded(double w, int k) {
+        return solveBoundedSteps(w, k, 0).run();
+    }
 
-        // Reconstruct path: follow backpointers from solvedCube back to initial.
-        T current = solvedCube;
-        while (!(current == rubiksCube)) {
-            RubiksCube::MOVE m = move_done[current];
-            moves.push_back(m);
-            current.invert(m);
+    // Anytime solve for a time budget: find some solution fast with a
+    // heavily weighted search, then keep looking for shorter ones with
+    // smaller weights, ending with plain IDA*, which proves the last one
+    // optimal. Each improvement is passed to onImproved. When the limit
+    // stops the search, the best solution so far is returned (empty if
+    // none was found) and isStopped() is true.
+    vector<RubiksCube::MOVE> solveAnytime(
+            const function<void(const vector<RubiksCube::MOVE>&)>& onImproved = nullptr) {
+        return solveAnytimeSteps(0, onImproved).run();
+    }
+
+    // The solves above as coroutines that yield after every sliceNodes
+    // nodes (0: never), so many of them can take turns on a few threads
+    // (see SolveScheduler). Each keeps its search state in the solver,
+    // which must outlive the task and run one solve at a time.
+    SolveTask solveSteps(uint32_t sliceNodes) {
+        return solveBoundedSteps(1.0, 0, sliceNodes);
+    }
+
+    SolveTask solveBoundedSteps(double w, int k, uint32_t sliceNodes) {
+        stopped = false;
+        stats = SearchStats();
+        ordering.clear();
+        weight = w;
+        slack = k;
+        maxLength = INT_MAX;
+        Progress progress = Progress::DONE;
+        if (startSearch(sliceNodes > 0)) {
+            while ((progress = continueSearch(sliceNodes)) == Progress::PAUSED) co_yield stats.nodesExpanded;
+        }
+        if (progress != Progress::FOUND) co_return vector<RubiksCube::MOVE>();
+        applySolution(moves);
+        co_return moves;
+    }
+
+    SolveTask solveAnytimeSteps(uint32_t sliceNodes,
+                                function<void(const vector<RubiksCube::MOVE>&)> onImproved = nullptr) {
+        static const double weights[] = {5.0, 3.0, 2.0, 1.5, 1.25, 1.0};
+        stopped = false;
+        stats = SearchStats();
+        ordering.clear();
+        slack = 0;
+        vector<RubiksCube::MOVE> best;
+        bool found = false;
+        double bestWeight = 1.0;
+        for (double w : weights) {
+            weight = w;
+            maxLength = found ? (int) best.size() - 1 : INT_MAX;
+            Progress progress = Progress::DONE;
+            if (startSearch(sliceNodes > 0)) {
+                while ((progress = continueSearch(sliceNodes)) == Progress::PAUSED) co_yield stats.nodesExpanded;
+            }
+            if (progress == Progress::FOUND) {
+                best = moves;
+                bestWeight = w;
+                found = true;
+                if (onImproved) onImproved(best);
+            } else if (!stopped) {
+                // Each pass is complete below maxLength: none is shorter
+                stats.lowerBound = best.size();
+                break;
+            }
+            // Nothing beats an already solved cube
+            if (stopped || (found && best.empty())) break;
         }
-        rubiksCube = solvedCube;
-        reverse(moves.begin(), moves.end());
-        return moves;
+        stats.weight = bestWeight;
+        stats.solutionLength = found ? (int) best.size() : -1;
+        if (found) applySolution(best);
+        co_return best;
     }
 };
 
-#endif // RUBIKS_CUBE_SOLVER_IDASTARSOLVER_H
\ No newline at end of file
+#endif // RUBIKS_CUBE_SOLVER_IDASTARSOLVER_H
@@ -5,27 +5,51 @@
 #include "../Model/RubiksCube.h"
 #include "DFSSolver.h"
 
-// Iterative-deepening DFS solver for Rubik's Cube
+// Iterative-deepening DFS solver for Rubik's Cube. With an endgame
+// database each depth starts with the move order learned by the ones
+// before; without one, moves are tried in MOVE order.
 // T: cube type; H: hash functor for that type
 
 template<typename T, typename H>
 class IDDFSSolver {
 private:
     int maxDepth;                            // maximum search depth
+    const EndgameDatabase *endgame;          // optional near-solved table
+    const SearchLimit *searchLimit = nullptr;  // optional deadline/cancellation
+    bool stopped = false;                    // last solve hit the limit
     vector<RubiksCube::MOVE> moves;          // solution moves
 
 public:
     T rubiksCube;                            // initial cube state
 
-    // Constructor: take starting cube and optional depth limit
-    IDDFSSolver(T cube, int depthLimit = 7)
-        : rubiksCube(cube), maxDepth(depthLimit) {}
+    // Constructor: take starting cube, optional depth limit and optional
+    // endgame database (which must outlive the solver)
+    IDDFSSolver(T cube, int depthLimit = 7, const EndgameDatabase *endgameDB = nullptr)
+        : maxDepth(depthLimit), endgame(endgameDB), rubiksCube(cube) {}
 
-    // Increase depth from 1 to maxDepth, run DFS each time
+    // Stop searching once limit is reached; it must outlive the solver
+    void setSearchLimit(const SearchLimit *limit) {
+        searchLimit = limit;
+    }
+
+    // Whether the last solve was cut short by the search limit
+    bool isStopped() const {
+        return stopped;
+    }
+
+    // Increase depth from 1 to maxDepth, run DFS each time. Returns no
+    // moves if the search limit stops it first.
     vector<RubiksCube::MOVE> solve() {
+        stopped = false;
+        // One solver for every depth: a failed search leaves its cube as it was
+        DFSSolver<T, H> dfs(rubiksCube, maxDepth, endgame);
+        dfs.setSearchLimit(searchLimit);
         for (int depth = 1; depth <= maxDepth; ++depth) {
-            DFSSolver<T, H> dfs(rubiksCube, depth);
-            moves = dfs.solve();
+            moves = dfs.solve(depth);
+            if (dfs.isStopped()) {
+                stopped = true;
+                break;
+            }
             if (dfs.rubiksCube.isSolved()) {
                 rubiksCube = dfs.rubiksCube;
                 break;
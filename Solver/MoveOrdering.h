@@ -0,0 +1,75 @@
+#ifndef RUBIKS_CUBE_SOLVER_MOVEORDERING_H
+#define RUBIKS_CUBE_SOLVER_MOVEORDERING_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "SearchStack.h"
+using namespace std;
+
+// Child ordering for iterative deepening that carries over from one
+// iteration to the next, so the last, successful one heads for the goal
+// first. At each ply the canonical moves are tried
+//   1. killer first: the move at that ply on the line to the node nearest
+//      the goal seen so far,
+//   2. then by score, lowest first (a heuristic estimate or endgame
+//      distance of the child),
+//   3. then by history: how often the move made progress at that ply.
+class MoveOrdering {
+public:
+    static const int MAX_DEPTH = 64;
+
+private:
+    int8_t killers[MAX_DEPTH];          // -1: no killer at this ply
+    uint32_t history[MAX_DEPTH][18];
+    int bestScore;                      // score of the killer line's end
+
+public:
+    MoveOrdering() {
+        clear();
+    }
+
+    // Forget everything, for a new cube
+    void clear() {
+        fill(begin(killers), end(killers), -1);
+        memset(history, 0, sizeof(history));
+        bestScore = INT_MAX;
+    }
+
+    // Call at every node with its score: a node nearer the goal than any
+    // before makes the moves leading to it the killers
+    template<typename Frame>
+    void visit(const SearchStack<Frame> &stack, int score) {
+        if (score >= bestScore) return;
+        bestScore = score;
+        int depth = stack.size();
+        for (int ply = 0; ply < depth; ply++) killers[ply] = (int8_t) stack.getMove(ply);
+        fill(killers + depth, end(killers), -1);
+    }
+
+    // Move m at ply got closer to the goal
+    void reward(int ply, int m) {
+        history[ply][m]++;
+    }
+
+    // Write the canonical moves after last to order, best first, given
+    // each child's score; returns how many there are
+    int sort(int ply, int last, const int *scores, uint8_t *order) const {
+        uint64_t keys[18];
+        int count = 0;
+        for (int m = 0; m < 18; m++) {
+            if (!isCanonicalMove(last, m)) continue;
+            uint64_t key = (uint64_t) (m != killers[ply]) << 63
+                         | (uint64_t) min(scores[m], 0x7FFF) << 48
+                         | (uint64_t) (UINT32_MAX - history[ply][m]) << 8
+                         | m;
+            // Insertion sort: at most 15 moves
+            int j = count++;
+            for (; j > 0 && keys[j - 1] > key; j--) keys[j] = keys[j - 1];
+            keys[j] = key;
+        }
+        for (int i = 0; i < count; i++) order[i] = keys[i] & 0xFF;
+        return count;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_MOVEORDERING_H
@@ -0,0 +1,52 @@
+#ifndef RUBIKS_CUBE_SOLVER_SEARCHLIMIT_H
+#define RUBIKS_CUBE_SOLVER_SEARCHLIMIT_H
+
+#include <bits/stdc++.h>
+using namespace std;
+
+// Deadline and cancellation flag shared between a running search and
+// whoever may stop it. Solvers poll it every few hundred nodes, so a stop
+// takes effect within a few milliseconds; a stopped solver
+// reports isStopped() and returns what it has (see each solver).
+class SearchLimit {
+    atomic<bool> cancelled{false};
+    chrono::steady_clock::time_point deadline;
+
+public:
+    // Number of nodes a solver expands between polls
+    static const uint32_t POLL_INTERVAL = 256;
+
+    // No deadline by default
+    explicit SearchLimit(chrono::steady_clock::time_point _deadline = chrono::steady_clock::time_point::max())
+        : deadline(_deadline) {}
+
+    // Deadline the given time from now
+    explicit SearchLimit(chrono::milliseconds budget)
+        : deadline(chrono::steady_clock::now() + budget) {}
+
+    // Stop the search as soon as it next polls; safe from any thread
+    void cancel() {
+        cancelled.store(true, memory_order_relaxed);
+    }
+
+    bool isCancelled() const {
+        return cancelled.load(memory_order_relaxed);
+    }
+
+    chrono::steady_clock::time_point getDeadline() const {
+        return deadline;
+    }
+
+    // Whether the search should stop now
+    bool reached() const {
+        return isCancelled() || chrono::steady_clock::now() >= deadline;
+    }
+
+    // Call once per node: checks reached() every POLL_INTERVAL calls of
+    // the same counter. A null limit never stops.
+    static bool poll(const SearchLimit *limit, uint32_t &counter) {
+        return limit && ++counter % POLL_INTERVAL == 0 && limit->reached();
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SEARCHLIMIT_H
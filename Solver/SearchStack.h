@@ -0,0 +1,69 @@
+#ifndef RUBIKS_CUBE_SOLVER_SEARCHSTACK_H
+#define RUBIKS_CUBE_SOLVER_SEARCHSTACK_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+using namespace std;
+
+// Preallocated storage for a depth-first search: one Frame per ply for the
+// solver's per-node data, and the moves leading to the current node. Each
+// thread has one stack per frame type, allocated on first use and reused
+// by every later search, so steady-state search does no heap allocation.
+// A thread runs one search per frame type at a time.
+template<typename Frame>
+class SearchStack {
+public:
+    // Deepest ply a search can reach; moves past it are not tried
+    static const int MAX_DEPTH = 64;
+
+private:
+    unique_ptr<Frame[]> frames;
+    array<RubiksCube::MOVE, MAX_DEPTH> path;
+    int length = 0;
+
+public:
+    SearchStack() : frames(make_unique<Frame[]>(MAX_DEPTH + 1)) {}
+
+    SearchStack(const SearchStack&) = delete;
+    SearchStack& operator=(const SearchStack&) = delete;
+
+    // The calling thread's stack
+    static SearchStack& forThread() {
+        static thread_local SearchStack stack;
+        return stack;
+    }
+
+    // Frame of the node at ply (0 is the root)
+    Frame& operator[](int ply) { return frames[ply]; }
+
+    void clear() { length = 0; }
+
+    // Moves from the root to the current node
+    int size() const { return length; }
+    bool full() const { return length == MAX_DEPTH; }
+
+    void push(RubiksCube::MOVE m) { path[length++] = m; }
+    void pop() { length--; }
+
+    // Move made at ply on the way to the current node
+    RubiksCube::MOVE getMove(int ply) const { return path[ply]; }
+
+    // Last move made, or -1 at the root
+    int last() const { return length ? (int) path[length - 1] : -1; }
+
+    vector<RubiksCube::MOVE> getPath() const {
+        return vector<RubiksCube::MOVE>(path.begin(), path.begin() + length);
+    }
+};
+
+// Whether move m may follow move last (-1 at the root) in a search that
+// only tries one ordering of equivalent sequences: a face is never turned
+// twice in a row, and of two opposite faces the one later in MOVE order
+// never comes first (R L is tried as L R).
+inline bool isCanonicalMove(int last, int m) {
+    if (last < 0) return true;
+    int lastFace = last / 3, face = m / 3;
+    return face != lastFace && !(face / 2 == lastFace / 2 && face < lastFace);
+}
+
+#endif // RUBIKS_CUBE_SOLVER_SEARCHSTACK_H
@@ -0,0 +1,54 @@
+#ifndef RUBIKS_CUBE_SOLVER_SEARCHSTATS_H
+#define RUBIKS_CUBE_SOLVER_SEARCHSTATS_H
+
+#include <bits/stdc++.h>
+using namespace std;
+
+// Counters and quality guarantees of one solve.
+struct SearchStats {
+    uint64_t nodesExpanded = 0;    // nodes visited by the search
+    uint64_t nodesGenerated = 0;   // children evaluated by the heuristic
+    uint64_t lastIterationExpanded = 0;   // nodes visited by the last pass
+    uint64_t tableCutoffs = 0;     // nodes cut by a transposition table bound
+    int iterations = 0;            // bounded passes run
+    double elapsedMs = 0;
+
+    int solutionLength = -1;       // -1 if no solution was found
+    int lowerBound = 0;            // proven lower bound on the optimal length
+
+    // Guarantee the search mode gives by construction:
+    // solutionLength <= weight * optimal + slack
+    double weight = 1.0;
+    int slack = 0;
+
+    // Achieved ratio bound: solutionLength / optimal is at most this.
+    // 1 when the solution is proven optimal.
+    double getRatioBound() const {
+        if (solutionLength <= 0) return 1.0;
+        double ratio = lowerBound > 0 ? (double) solutionLength / lowerBound : weight;
+        return min(ratio, weight + (double) slack / max(lowerBound, 1));
+    }
+
+    // Achieved additive bound: solutionLength - optimal is at most this
+    int getExcessBound() const {
+        if (solutionLength < 0) return 0;
+        return solutionLength - lowerBound;
+    }
+
+    void print(ostream &out = cout) const {
+        out << "nodes expanded: " << nodesExpanded
+            << ", generated: " << nodesGenerated
+            << ", iterations: " << iterations
+            << " (last " << lastIterationExpanded << " nodes)"
+            << ", table cutoffs: " << tableCutoffs
+            << ", time: " << elapsedMs << " ms\n";
+        if (solutionLength >= 0) {
+            out << "length: " << solutionLength
+                << ", lower bound: " << lowerBound
+                << ", within x" << getRatioBound()
+                << " / +" << getExcessBound() << " of optimal\n";
+        }
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SEARCHSTATS_H
@@ -0,0 +1,145 @@
+#ifndef RUBIKS_CUBE_SOLVER_SOLUTIONCACHE_H
+#define RUBIKS_CUBE_SOLVER_SOLUTIONCACHE_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../Model/FaceletCube.h"
+
+// Bounded LRU cache of solutions, safe to share between solver threads.
+// Cubes are keyed by their canonical form: the smallest facelet string over
+// all 48 symmetries of the cube and of its inverse. One cached solve then
+// answers every rotated, mirrored or inverted variant of that cube, with
+// the stored moves mapped back into the caller's frame.
+
+class SolutionCache {
+private:
+    typedef vector<RubiksCube::MOVE> Moves;
+
+    // Canonical form of a cube and how to get there from the cube
+    struct Canonical {
+        FaceletCube key;
+        int sym;          // symmetry applied
+        bool inverted;    // applied to the inverse cube
+    };
+
+    // Each shard is an independent LRU list behind its own lock
+    struct Shard {
+        mutex lock;
+        list<pair<FaceletCube, Moves>> entries;   // most recent first
+        unordered_map<FaceletCube, list<pair<FaceletCube, Moves>>::iterator, HashFacelet> index;
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+    atomic<size_t> hits{0}, misses{0};
+
+    static Canonical canonicalize(const FaceletCube &cube) {
+        Canonical best{cube, 0, false};
+        FaceletCube inverse = cube.inverse();
+        for (int inv = 0; inv < 2; inv++) {
+            const FaceletCube &base = inv ? inverse : cube;
+            for (int sym = 0; sym < FaceletCube::NUM_SYMMETRIES; sym++) {
+                FaceletCube candidate = base.conjugate(sym);
+                if (candidate < best.key) {
+                    best = {candidate, sym, inv == 1};
+                }
+            }
+        }
+        return best;
+    }
+
+    // A sequence solving X, turned into one solving X's inverse and back
+    static Moves invertSequence(const Moves &moves) {
+        Moves res;
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+            res.push_back(RubiksCube::getInverseMove(*it));
+        }
+        return res;
+    }
+
+    static Moves mapSequence(const Moves &moves, int sym) {
+        Moves res;
+        for (auto m : moves) res.push_back(FaceletCube::getSymmetricMove(m, sym));
+        return res;
+    }
+
+    // Solution of the caller's cube -> solution of its canonical form
+    static Moves toCanonical(const Moves &solution, const Canonical &c) {
+        return mapSequence(c.inverted ? invertSequence(solution) : solution, c.sym);
+    }
+
+    // Solution of the canonical form -> solution of the caller's cube
+    static Moves fromCanonical(const Moves &solution, const Canonical &c) {
+        Moves res = mapSequence(solution, FaceletCube::getInverseSymmetry(c.sym));
+        return c.inverted ? invertSequence(res) : res;
+    }
+
+    Shard& getShard(const FaceletCube &key) {
+        return *shards[HashFacelet()(key) % shards.size()];
+    }
+
+public:
+    // capacity: total number of cached solutions across all shards
+    SolutionCache(size_t capacity, size_t numShards = 16)
+        : shardCapacity(max<size_t>(1, capacity / numShards)) {
+        for (size_t i = 0; i < numShards; i++) shards.push_back(make_unique<Shard>());
+    }
+
+    // Fill solution and return true if cube or any symmetric/inverse
+    // variant of it has been cached
+    bool lookup(const RubiksCube &cube, Moves &solution) {
+        Canonical c = canonicalize(FaceletCube::fromCube(cube));
+        Shard &shard = getShard(c.key);
+        Moves stored;
+        {
+            lock_guard<mutex> guard(shard.lock);
+            auto it = shard.index.find(c.key);
+            if (it == shard.index.end()) {
+                misses++;
+                return false;
+            }
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            stored = it->second->second;
+        }
+        hits++;
+        solution = fromCanonical(stored, c);
+        return true;
+    }
+
+    // Remember a solution for cube, evicting the least recently used entry
+    // of its shard when full
+    void insert(const RubiksCube &cube, const Moves &solution) {
+        Canonical c = canonicalize(FaceletCube::fromCube(cube));
+        Moves canonical = toCanonical(solution, c);
+        Shard &shard = getShard(c.key);
+        lock_guard<mutex> guard(shard.lock);
+        auto it = shard.index.find(c.key);
+        if (it != shard.index.end()) {
+            it->second->second = canonical;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        shard.entries.emplace_front(c.key, canonical);
+        shard.index[c.key] = shard.entries.begin();
+        if (shard.entries.size() > shardCapacity) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+    }
+
+    // Answer from the cache, or run solve() (returning the moves for cube)
+    // and cache its result
+    template<typename F>
+    Moves solve(const RubiksCube &cube, F solve) {
+        Moves solution;
+        if (lookup(cube, solution)) return solution;
+        solution = solve();
+        insert(cube, solution);
+        return solution;
+    }
+
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SOLUTIONCACHE_H
@@ -0,0 +1,89 @@
+#ifndef RUBIKS_CUBE_SOLVER_SOLUTIONSIMPLIFIER_H
+#define RUBIKS_CUBE_SOLVER_SOLUTIONSIMPLIFIER_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+using namespace std;
+
+// Post-processing of move sequences returned by the solvers. Moves on the
+// same axis commute, so any run of them reduces to at most one turn of
+// each of its two faces: simplify() merges such runs, drops turns that
+// cancel, and writes each run in MOVE order (L before R, U before D,
+// F before B). The result does the same to the cube and is never longer.
+class SolutionSimplifier {
+public:
+    // Ways to count a solution's length:
+    // HTM: every face turn counts 1
+    // QTM: half turns count 2
+    // STM: a slice turn (opposite faces turned the same way as one middle
+    //      layer, like R L' or R2 L2) counts 1, as does every other turn
+    enum class Metric { HTM, QTM, STM };
+
+private:
+    // Axis 0: L/R, 1: U/D, 2: F/B; face 0 or 1 within the axis
+    static int getAxis(RubiksCube::MOVE m) { return (int) m / 6; }
+    static int getSide(RubiksCube::MOVE m) { return (int) m / 3 % 2; }
+
+    // Clockwise quarter turns: 1 for X, 3 for X', 2 for X2
+    static int getQuarterTurns(RubiksCube::MOVE m) {
+        static const int turns[3] = {1, 3, 2};
+        return turns[(int) m % 3];
+    }
+
+    // Turn of side on axis by quarter (1..3) clockwise quarter turns
+    static RubiksCube::MOVE makeMove(int axis, int side, int quarter) {
+        static const int suffix[4] = {-1, 0, 2, 1};
+        return RubiksCube::MOVE(axis * 6 + side * 3 + suffix[quarter]);
+    }
+
+    // Pending turns of both faces of one axis
+    struct Block {
+        int axis;
+        int quarter[2];
+    };
+
+public:
+    static vector<RubiksCube::MOVE> simplify(const vector<RubiksCube::MOVE> &moves) {
+        // A run that cancels out is popped, so the run before it can merge
+        // with the moves after it
+        vector<Block> blocks;
+        for (auto m : moves) {
+            int axis = getAxis(m);
+            if (blocks.empty() || blocks.back().axis != axis) blocks.push_back({axis, {0, 0}});
+            Block &top = blocks.back();
+            top.quarter[getSide(m)] = (top.quarter[getSide(m)] + getQuarterTurns(m)) % 4;
+            if (!top.quarter[0] && !top.quarter[1]) blocks.pop_back();
+        }
+
+        vector<RubiksCube::MOVE> result;
+        for (auto &block : blocks) {
+            for (int side = 0; side < 2; side++) {
+                if (block.quarter[side]) result.push_back(makeMove(block.axis, side, block.quarter[side]));
+            }
+        }
+        return result;
+    }
+
+    // Length of moves as given; simplify first for the shortest count
+    static int getLength(const vector<RubiksCube::MOVE> &moves, Metric metric) {
+        int length = 0;
+        for (size_t i = 0; i < moves.size(); i++) {
+            if (metric == Metric::QTM) {
+                length += getQuarterTurns(moves[i]) == 2 ? 2 : 1;
+                continue;
+            }
+            length++;
+            // R L' turns both outer layers the same way round the axis:
+            // a middle-layer turn plus a free cube rotation
+            if (metric == Metric::STM && i + 1 < moves.size()
+                && getAxis(moves[i]) == getAxis(moves[i + 1])
+                && getSide(moves[i]) != getSide(moves[i + 1])
+                && (getQuarterTurns(moves[i]) + getQuarterTurns(moves[i + 1])) % 4 == 0) {
+                i++;
+            }
+        }
+        return length;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SOLUTIONSIMPLIFIER_H
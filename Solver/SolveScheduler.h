@@ -0,0 +1,147 @@
+#ifndef RUBIKS_CUBE_SOLVER_SOLVESCHEDULER_H
+#define RUBIKS_CUBE_SOLVER_SOLVESCHEDULER_H
+
+#include <bits/stdc++.h>
+#include "SolveTask.h"
+using namespace std;
+
+// Fixed pool of threads taking turns on any number of SolveTasks. Each
+// thread repeatedly takes the queued task due next, runs one slice of it
+// and queues it again unless it finished. Due next is the task with the
+// highest priority, then the one that has run the fewest slices, then the
+// oldest: a new task starts at once, and short solves finish while long
+// ones are still running instead of waiting behind them.
+// Tasks report their results themselves, from their coroutine body, and
+// should catch their own errors to report them too: a task that throws
+// anyway is dropped, with the error logged to cerr.
+class SolveScheduler {
+    struct Entry {
+        SolveTask task;
+        int priority = 0;
+        uint64_t slices = 0;            // run so far
+        bool running = false;
+    };
+
+    // Queue order: highest priority, fewest slices, oldest id
+    typedef tuple<int, uint64_t, uint64_t> Key;
+
+    mutex lock;
+    condition_variable ready;           // threads wait for queued tasks
+    condition_variable idle;            // waitIdle() waits for no tasks
+    unordered_map<uint64_t, Entry> tasks;   // queued or running
+    set<Key> queue;
+    uint64_t nextId = 1;
+    bool stopping = false;
+    vector<thread> threads;
+
+    static Key getKey(uint64_t id, const Entry &entry) {
+        return {-entry.priority, entry.slices, id};
+    }
+
+    void threadLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            ready.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            uint64_t id = get<2>(*queue.begin());
+            queue.erase(queue.begin());
+            Entry &entry = tasks.at(id);
+            entry.running = true;
+
+            guard.unlock();
+            bool more = false;
+            try {
+                more = entry.task.next();
+            } catch (const char *e) {
+                cerr << "SolveScheduler: task " << id << " failed: " << e << "\n";
+            } catch (const exception &e) {
+                cerr << "SolveScheduler: task " << id << " failed: " << e.what() << "\n";
+            } catch (...) {
+                cerr << "SolveScheduler: task " << id << " failed\n";
+            }
+            guard.lock();
+
+            entry.running = false;
+            entry.slices++;
+            if (more) {
+                queue.insert(getKey(id, entry));
+                continue;
+            }
+            // Destroy the finished coroutine outside the lock
+            SolveTask finished = std::move(entry.task);
+            tasks.erase(id);
+            if (tasks.empty()) idle.notify_all();
+            guard.unlock();
+            finished = SolveTask();
+            guard.lock();
+        }
+    }
+
+public:
+    // onStart, if given, runs first on each thread with its number, e.g.
+    // to pin it to a NUMA node
+    explicit SolveScheduler(int numThreads, const function<void(int)> &onStart = nullptr) {
+        for (int i = 0; i < max(numThreads, 1); i++) {
+            threads.emplace_back([this, onStart, i] {
+                if (onStart) onStart(i);
+                threadLoop();
+            });
+        }
+    }
+
+    SolveScheduler(const SolveScheduler&) = delete;
+    SolveScheduler& operator=(const SolveScheduler&) = delete;
+
+    // Lets running slices end; tasks not finished by then are destroyed
+    // unfinished
+    ~SolveScheduler() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    // Queue a task; returns its id for setPriority()
+    uint64_t submit(SolveTask task, int priority = 0) {
+        uint64_t id;
+        {
+            lock_guard<mutex> guard(lock);
+            id = nextId++;
+            Entry &entry = tasks[id];
+            entry.task = std::move(task);
+            entry.priority = priority;
+            queue.insert(getKey(id, entry));
+        }
+        ready.notify_one();
+        return id;
+    }
+
+    // Change a task's priority; a running one gets it when queued again.
+    // Returns false if the task finished.
+    bool setPriority(uint64_t id, int priority) {
+        lock_guard<mutex> guard(lock);
+        auto it = tasks.find(id);
+        if (it == tasks.end()) return false;
+        Entry &entry = it->second;
+        if (!entry.running) queue.erase(getKey(id, entry));
+        entry.priority = priority;
+        if (!entry.running) queue.insert(getKey(id, entry));
+        return true;
+    }
+
+    // Tasks queued or running
+    size_t size() {
+        lock_guard<mutex> guard(lock);
+        return tasks.size();
+    }
+
+    // Block until every submitted task has finished
+    void waitIdle() {
+        unique_lock<mutex> guard(lock);
+        idle.wait(guard, [this] { return tasks.empty(); });
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SOLVESCHEDULER_H
@@ -0,0 +1,107 @@
+#ifndef RUBIKS_CUBE_SOLVER_SOLVETASK_H
+#define RUBIKS_CUBE_SOLVER_SOLVETASK_H
+
+#include <bits/stdc++.h>
+#include <coroutine>
+#include "../Model/RubiksCube.h"
+using namespace std;
+
+// A solve running as a C++20 coroutine, in slices: each next() runs it
+// until it yields, typically after a fixed number of search nodes, or
+// finishes. Between slices it holds no thread, so one thread can take
+// turns on any number of solves (see SolveScheduler), and a slice may run
+// on a different thread than the one before. A solve yields its progress,
+// nodes expanded so far, and returns its moves.
+//
+// The coroutine body:
+//   SolveTask solveSomehow(...) {
+//       while (...) { ...; co_yield nodes; }
+//       co_return moves;
+//   }
+class SolveTask {
+public:
+    struct promise_type {
+        uint64_t progress = 0;
+        vector<RubiksCube::MOVE> result;
+        exception_ptr error;
+
+        SolveTask get_return_object() {
+            return SolveTask(coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        // Nothing runs until the first next()
+        suspend_always initial_suspend() noexcept { return {}; }
+        suspend_always final_suspend() noexcept { return {}; }
+
+        suspend_always yield_value(uint64_t nodes) {
+            progress = nodes;
+            return {};
+        }
+
+        void return_value(vector<RubiksCube::MOVE> moves) {
+            result = std::move(moves);
+        }
+
+        void unhandled_exception() {
+            error = current_exception();
+        }
+    };
+
+private:
+    coroutine_handle<promise_type> handle;
+
+    explicit SolveTask(coroutine_handle<promise_type> h) : handle(h) {}
+
+public:
+    SolveTask() = default;
+
+    SolveTask(SolveTask &&other) noexcept : handle(exchange(other.handle, nullptr)) {}
+
+    SolveTask& operator=(SolveTask &&other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    // Destroying an unfinished task abandons the solve
+    ~SolveTask() {
+        if (handle) handle.destroy();
+    }
+
+    bool valid() const {
+        return (bool) handle;
+    }
+
+    bool done() const {
+        return handle.done();
+    }
+
+    // Run the next slice; returns false once the solve has finished. An
+    // error thrown by the solve is thrown again here.
+    bool next() {
+        if (!handle.done()) handle.resume();
+        if (!handle.done()) return true;
+        if (handle.promise().error) rethrow_exception(exchange(handle.promise().error, nullptr));
+        return false;
+    }
+
+    // Nodes expanded by the last slice's end
+    uint64_t getProgress() const {
+        return handle.promise().progress;
+    }
+
+    // The solution, once done()
+    vector<RubiksCube::MOVE>& getResult() {
+        return handle.promise().result;
+    }
+
+    // Run to the end on this thread
+    vector<RubiksCube::MOVE> run() {
+        while (next()) {}
+        return std::move(getResult());
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_SOLVETASK_H
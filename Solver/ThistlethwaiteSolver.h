@@ -0,0 +1,65 @@
+#ifndef RUBIKS_CUBE_SOLVER_THISTLETHWAITESOLVER_H
+#define RUBIKS_CUBE_SOLVER_THISTLETHWAITESOLVER_H
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../Model/CubieCube.h"
+#include "../PatternDatabases/ThistlethwaiteDatabase.h"
+#include "SolutionSimplifier.h"
+
+// Thistlethwaite's four-phase solver for a Rubik's Cube model T (see
+// ThistlethwaiteDatabase). Each phase walks its table down, taking any
+// move of its group that brings the cube one move closer to the next
+// group, so a solve is a few hundred lookups with no search and no table
+// over 600KB. Solutions average about 31 moves, 39 at the longest over
+// thousands of random scrambles, within the worst case of 7 + 10 + 13 + 15
+// before the phase joins are simplified; they are not optimal.
+// T must support move() and isSolved().
+template<typename T>
+class ThistlethwaiteSolver {
+    array<int, ThistlethwaiteDatabase::NUM_PHASES> phaseLengths{};
+
+public:
+    T rubiksCube;
+
+    ThistlethwaiteSolver(T cube) : rubiksCube(cube) {}
+
+    // Solve, apply the solution to rubiksCube and return it. Throws if
+    // the cube can't be solved (a cubie twisted or flipped in place, two
+    // swapped).
+    vector<RubiksCube::MOVE> solve() {
+        CubieCube cube = CubieCube::fromCube(rubiksCube);
+        vector<RubiksCube::MOVE> solution;
+        for (int phase = 0; phase < ThistlethwaiteDatabase::NUM_PHASES; phase++) {
+            const ThistlethwaiteDatabase &db = ThistlethwaiteDatabase::getInstance(phase);
+            size_t start = solution.size();
+            for (uint8_t dist = db.getNumMoves(db.getDatabaseIndex(cube)); dist > 0; dist--) {
+                bool found = false;
+                for (RubiksCube::MOVE m : ThistlethwaiteDatabase::getMoves(phase)) {
+                    CubieCube next = cube;
+                    next.move(m);
+                    if (db.getNumMoves(db.getDatabaseIndex(next)) == dist - 1) {
+                        cube = next;
+                        solution.push_back(m);
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) throw "Cube is not solvable";
+            }
+            phaseLengths[phase] = solution.size() - start;
+        }
+
+        solution = SolutionSimplifier::simplify(solution);
+        for (auto m : solution) rubiksCube.move(m);
+        assert(rubiksCube.isSolved());
+        return solution;
+    }
+
+    // Moves each phase of the last solve took, before simplifying
+    const array<int, ThistlethwaiteDatabase::NUM_PHASES>& getPhaseLengths() const {
+        return phaseLengths;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_THISTLETHWAITESOLVER_H
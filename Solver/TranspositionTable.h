@@ -0,0 +1,117 @@
+#ifndef RUBIKS_CUBE_SOLVER_TRANSPOSITIONTABLE_H
+#define RUBIKS_CUBE_SOLVER_TRANSPOSITIONTABLE_H
+
+#include <bits/stdc++.h>
+#include "../Model/CubieCube.h"
+using namespace std;
+
+// Fixed-size table of proven lower bounds on the distance of cube states
+// from solved, for IDA* to cut transpositions: once a state's subtree
+// failed under some bound, reaching it again by another path is cut by the
+// stored bound rather than searched again. The search below a state only
+// tries canonical moves (see isCanonicalMove), which depend on the move
+// that led there, so a bound holds for the state together with the face
+// of that move: getSearchKey() puts both in the key. Such a bound does not
+// depend on where the search started, so the table may be shared by
+// iterations, solves and threads.
+//
+// Lock-free: an entry is two words, the key's low word stored XORed with
+// the other, so a torn read fails the key check and counts as a miss.
+// Buckets of four entries fill one cache line; when full, the entry with
+// the least search effort behind it is replaced (depth-preferred).
+class TranspositionTable {
+    static const int BOUND_SHIFT = 40;      // hi word: 40 bits of corner key,
+    static const int EFFORT_SHIFT = 48;     // then bound and effort bytes
+    static const uint64_t KEY_MASK = (1ull << BOUND_SHIFT) - 1;
+
+    struct Entry {
+        atomic<uint64_t> check{0};          // key.lo ^ data
+        atomic<uint64_t> data{0};           // key.hi | bound | effort
+    };
+
+    struct alignas(64) Bucket {
+        Entry entries[4];
+    };
+
+    unique_ptr<Bucket[]> buckets;
+    uint64_t mask;                          // bucket count - 1
+
+    size_t getIndex(const CubeKey &key) const {
+        uint64_t h = (key.lo ^ (key.hi * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return (h ^ (h >> 31)) & mask;
+    }
+
+public:
+    // Key of cube state reached by move last (-1: none, at the root). The
+    // face goes in the high bits CubieCube::getKey() leaves clear.
+    static CubeKey getSearchKey(CubeKey key, int last) {
+        key.lo |= (uint64_t) (last < 0 ? 0 : last / 3 + 1) << 60;
+        return key;
+    }
+
+    // Largest power-of-two number of buckets that fits in megabytes
+    explicit TranspositionTable(size_t megabytes = 64) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= megabytes << 20) count *= 2;
+        buckets = make_unique<Bucket[]>(count);
+        mask = count - 1;
+    }
+
+    // Proven lower bound on the distance of key from solved by canonical
+    // moves, 0 if unknown
+    uint8_t getBound(const CubeKey &key) const {
+        for (const Entry &e : buckets[getIndex(key)].entries) {
+            uint64_t data = e.data.load(memory_order_relaxed);
+            uint64_t check = e.check.load(memory_order_relaxed);
+            if ((data & KEY_MASK) == key.hi && (check ^ data) == key.lo) {
+                return (data >> BOUND_SHIFT) & 0xFF;
+            }
+        }
+        return 0;
+    }
+
+    void prefetch(const CubeKey &key) const {
+        __builtin_prefetch(&buckets[getIndex(key)]);
+    }
+
+    // Record that key is at least bound moves from solved. effort ranks
+    // entries for replacement, e.g. the depth left below the state.
+    void store(const CubeKey &key, uint8_t bound, uint8_t effort) {
+        Entry *victim = nullptr;
+        int victimEffort = INT_MAX;
+        for (Entry &e : buckets[getIndex(key)].entries) {
+            uint64_t data = e.data.load(memory_order_relaxed);
+            uint64_t check = e.check.load(memory_order_relaxed);
+            if ((data & KEY_MASK) == key.hi && (check ^ data) == key.lo) {
+                if (bound <= ((data >> BOUND_SHIFT) & 0xFF)) return;
+                effort = max<uint8_t>(effort, data >> EFFORT_SHIFT);
+                victim = &e;
+                break;
+            }
+            int entryEffort = data ? (int) (data >> EFFORT_SHIFT) : -1;
+            if (entryEffort < victimEffort) {
+                victim = &e;
+                victimEffort = entryEffort;
+            }
+        }
+        uint64_t data = key.hi | (uint64_t) bound << BOUND_SHIFT | (uint64_t) effort << EFFORT_SHIFT;
+        victim->data.store(data, memory_order_relaxed);
+        victim->check.store(key.lo ^ data, memory_order_relaxed);
+    }
+
+    // Forget every state; not safe while searches use the table
+    void clear() {
+        for (size_t i = 0; i <= mask; i++) {
+            for (Entry &e : buckets[i].entries) {
+                e.data.store(0, memory_order_relaxed);
+                e.check.store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const {
+        return (mask + 1) * 4;
+    }
+};
+
+#endif // RUBIKS_CUBE_SOLVER_TRANSPOSITIONTABLE_H
@@ -0,0 +1,112 @@
+// Round trips through BlockCompressedFile and checks that damaged files
+// are rejected with an error rather than crashing or decoding garbage.
+
+#include <bits/stdc++.h>
+#include "../PatternDatabases/BlockCompressedFile.h"
+using namespace std;
+
+namespace {
+    const string path = (filesystem::temp_directory_path() / "block_compressed_file_test.dbz").string();
+    bool ok = true;
+
+    void expect(bool condition, const string &what) {
+        cout << (condition ? "ok     " : "FAILED ") << what << "\n";
+        ok &= condition;
+    }
+
+    // Nibble-packed depths skewed like a pattern database's
+    vector<uint8_t> makeData(size_t size, uint32_t seed) {
+        mt19937 rng(seed);
+        vector<uint8_t> data(size);
+        for (auto &b : data) {
+            auto depth = [&] { return (uint8_t) min<uint32_t>(15, 8 + (rng() % 100 < 60) + (rng() % 100 < 20) * 2); };
+            b = depth() << 4 | depth();
+        }
+        return data;
+    }
+
+    vector<uint8_t> readBytes() {
+        ifstream in(path, ios::binary);
+        return vector<uint8_t>(istreambuf_iterator<char>(in), {});
+    }
+
+    void writeBytes(const vector<uint8_t> &bytes) {
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    // Whether reading the file into size bytes throws
+    bool readThrows(size_t size) {
+        vector<uint8_t> dest(size);
+        try {
+            BlockCompressedFile::read(path, dest.data(), size, 2);
+        } catch (const char *) {
+            return true;
+        }
+        return false;
+    }
+
+    bool roundTrip(const vector<uint8_t> &data, size_t blockBytes) {
+        BlockCompressedFile::write(path, data.data(), data.size(), blockBytes, 2);
+        vector<uint8_t> back(data.size());
+        return BlockCompressedFile::isCompressed(path) &&
+               BlockCompressedFile::read(path, back.data(), back.size(), 2) && back == data;
+    }
+}
+
+int main() {
+    vector<uint8_t> data = makeData(300000, 1);
+    expect(roundTrip(data, 1 << 16), "round trip, several blocks and a short last one");
+    expect(roundTrip(data, 1 << 20), "round trip, one block");
+    expect(roundTrip(vector<uint8_t>(5000, 0x77), 1024), "round trip, a single byte value");
+    vector<uint8_t> all(256 * 64);
+    for (size_t i = 0; i < all.size(); i++) all[i] = (uint8_t) i;
+    expect(roundTrip(all, 4096), "round trip, every byte value");
+
+    BlockCompressedFile::write(path, data.data(), data.size(), 1 << 16, 2);
+    const vector<uint8_t> good = readBytes();
+    uint32_t numBlocks;
+    memcpy(&numBlocks, good.data() + 20, 4);
+    const size_t firstBlock = 24 + (numBlocks + 1) * 8;
+
+    expect(readThrows(data.size() + 1), "wrong raw size throws");
+
+    // Code lengths over 12 fit in a nibble but no decoder table
+    vector<uint8_t> bad = good;
+    bad[firstBlock] = 0xFF;
+    writeBytes(bad);
+    expect(readThrows(data.size()), "code length 15 throws");
+
+    bad = good;
+    bad[firstBlock + 5] = 0xD0;
+    writeBytes(bad);
+    expect(readThrows(data.size()), "code length 13 throws");
+
+    // Lengths that overfill the code space
+    bad = good;
+    fill(bad.begin() + firstBlock, bad.begin() + firstBlock + 128, 0x11);
+    writeBytes(bad);
+    expect(readThrows(data.size()), "lengths that are no prefix code throw");
+
+    bad = good;
+    bad.resize(bad.size() - 100);
+    writeBytes(bad);
+    expect(readThrows(data.size()), "truncated file throws");
+
+    bad = good;
+    bad[3] ^= 1;
+    writeBytes(bad);
+    expect(!BlockCompressedFile::isCompressed(path) && readThrows(data.size()), "bad magic throws");
+
+    // Damaged coded bits may decode to other bytes, but must not crash
+    bad = good;
+    mt19937 rng(2);
+    for (int i = 0; i < 2000; i++) bad[firstBlock + 128 + rng() % 1000] = rng();
+    writeBytes(bad);
+    readThrows(data.size());
+    expect(true, "damaged coded bits do not crash");
+
+    filesystem::remove(path);
+    expect(!BlockCompressedFile::read(path, bad.data(), 1, 1), "missing file returns false");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// Steady-state allocation check for the depth-first solvers: once a
+// thread's SearchStack exists, a solve allocates a fixed handful of times
+// (the returned moves, the solve coroutine), however many nodes it
+// searches. Counts every operator new while solving an easy and a much
+// harder scramble with each solver and fails if the harder one allocates
+// more.
+
+#include <bits/stdc++.h>
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Solver/DFSSolver.h"
+#include "../Solver/IDDFSSolver.h"
+#include "../Solver/IDAstarSolver.h"
+using namespace std;
+
+namespace {
+    atomic<uint64_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t align) {
+    allocations++;
+    size_t a = (size_t) align;
+    if (void *p = aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, align_val_t) noexcept { free(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { free(p); }
+
+namespace {
+    typedef RubiksCubeBitboard Cube;
+    typedef IDAstarSolver<Cube, HashBitboard, EdgeCountHeuristic> EdgeIDAstar;
+
+    Cube scramble(const vector<RubiksCube::MOVE> &moves) {
+        Cube cube;
+        for (auto m : moves) cube.move(m);
+        return cube;
+    }
+
+    // Allocations made by solve(cube), which must solve it
+    template<typename Solve>
+    uint64_t countAllocations(const Cube &cube, Solve solve) {
+        uint64_t before = allocations.load();
+        bool solved = solve(cube);
+        uint64_t count = allocations.load() - before;
+        if (!solved) {
+            cerr << "scramble not solved\n";
+            exit(1);
+        }
+        return count;
+    }
+
+    // Fails unless the hard solve allocates no more than the easy one
+    template<typename Solve>
+    bool check(const string &name, const Cube &easy, const Cube &hard, Solve solve) {
+        countAllocations(easy, solve);          // first solve sets up the thread's stack
+        uint64_t easyCount = countAllocations(easy, solve);
+        uint64_t hardCount = countAllocations(hard, solve);
+        bool ok = hardCount <= easyCount;
+        cout << name << ": " << easyCount << " allocations (easy), " << hardCount
+             << " (hard)" << (ok ? "" : "  FAILED") << "\n";
+        return ok;
+    }
+}
+
+int main() {
+    using M = RubiksCube::MOVE;
+    Cube easy = scramble({M::R, M::U});
+    Cube hard = scramble({M::R, M::U, M::F, M::L2, M::D});
+    bool ok = true;
+
+    ok &= check("DFSSolver", easy, hard, [](const Cube &cube) {
+        DFSSolver<Cube, HashBitboard> solver(cube, 5);
+        solver.solve();
+        return solver.rubiksCube.isSolved();
+    });
+
+    ok &= check("IDDFSSolver", easy, hard, [](const Cube &cube) {
+        IDDFSSolver<Cube, HashBitboard> solver(cube, 5);
+        solver.solve();
+        return solver.rubiksCube.isSolved();
+    });
+
+    // The calls are: warm-up, easy, hard. The hard scramble must search
+    // far more nodes for the counts to mean anything.
+    Cube harder = scramble({M::R, M::U, M::F, M::L2, M::D, M::B, M::R2});
+    uint64_t nodes[3];
+    int call = 0;
+    ok &= check("IDAstarSolver", easy, harder, [&](const Cube &cube) {
+        EdgeIDAstar solver(cube, EdgeCountHeuristic());
+        solver.solve();
+        nodes[call++] = solver.getStats().nodesExpanded;
+        return solver.rubiksCube.isSolved();
+    });
+    cout << "IDAstarSolver nodes: " << nodes[1] << " (easy), " << nodes[2] << " (hard)\n";
+    if (nodes[2] < 1000 * nodes[1]) {
+        cout << "hard scramble too easy to tell\n";
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// SolveScheduler on one thread: short tasks submitted behind a long one
+// finish first, and a task that throws is dropped without taking the
+// thread or waitIdle() down with it.
+
+#include <bits/stdc++.h>
+#include "../Solver/SolveScheduler.h"
+using namespace std;
+
+namespace {
+    bool ok = true;
+
+    void expect(bool condition, const string &what) {
+        cout << (condition ? "ok     " : "FAILED ") << what << "\n";
+        ok &= condition;
+    }
+
+    // Yields slices times, then records name as finished
+    SolveTask work(string name, int slices, vector<string> *finished, mutex *lock) {
+        for (int i = 0; i < slices; i++) co_yield (uint64_t) i;
+        lock_guard<mutex> guard(*lock);
+        finished->push_back(name);
+        co_return vector<RubiksCube::MOVE>();
+    }
+
+    SolveTask failing(int slices) {
+        for (int i = 0; i < slices; i++) co_yield (uint64_t) i;
+        throw "task failed on purpose";
+    }
+}
+
+int main() {
+    vector<string> finished;
+    mutex lock;
+    {
+        SolveScheduler scheduler(1);
+        scheduler.submit(work("long", 10000, &finished, &lock));
+        scheduler.submit(failing(3));
+        for (int i = 0; i < 5; i++) scheduler.submit(work("short", 5, &finished, &lock));
+        scheduler.waitIdle();
+        expect(scheduler.size() == 0, "waitIdle() returns once every task is done, the failed one too");
+
+        // The pool still runs tasks after one threw
+        scheduler.submit(work("after", 1, &finished, &lock));
+        scheduler.waitIdle();
+    }
+
+    expect(finished.size() == 7, "every other task finished");
+    expect(find(finished.begin(), finished.end(), "long") - finished.begin() == 5,
+           "short tasks finish before the long one submitted first");
+    expect(!finished.empty() && finished.back() == "after", "tasks run after a failure");
+    return ok ? 0 : 1;
+}